@@ -0,0 +1,79 @@
+#include "catalogue_loader.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace transport_catalogue {
+
+using namespace std::literals;
+
+CatalogueLoader::CatalogueLoader(TransportCatalogue& catalogue)
+    : catalogue_(catalogue) {
+}
+
+void CatalogueLoader::AddStop(const Stop& stop) {
+    catalogue_.AdoptStop(stop);
+}
+
+void CatalogueLoader::AddDistance(std::string_view from, std::string_view to, int distance) {
+    auto from_id = catalogue_.FindStopId(from);
+    auto to_id = catalogue_.FindStopId(to);
+    if (from_id && to_id) {
+        catalogue_.AddDistance(*from_id, *to_id, distance);
+    } else {
+        pending_distances_.push_back({from, to, distance});
+    }
+}
+
+void CatalogueLoader::AddBus(std::string_view name, const std::vector<std::string_view>& stops, bool is_round) {
+    // Автобус за отложенным тоже откладывается, чтобы не нарушить порядок идентификаторов
+    if (pending_buses_.empty()) {
+        stop_ids_.clear();
+        for (std::string_view stop_name : stops) {
+            auto stop_id = catalogue_.FindStopId(stop_name);
+            if (!stop_id.has_value()) {
+                break;
+            }
+            stop_ids_.push_back(*stop_id);
+        }
+        if (stop_ids_.size() == stops.size()) {
+            catalogue_.AdoptBus({name, {stop_ids_.data(), stop_ids_.data() + stop_ids_.size()}, is_round});
+            return;
+        }
+    }
+
+    const size_t stops_begin = pending_bus_stops_.size();
+    pending_bus_stops_.insert(pending_bus_stops_.end(), stops.begin(), stops.end());
+    pending_buses_.push_back({name, stops_begin, pending_bus_stops_.size(), is_round});
+}
+
+void CatalogueLoader::Finish() {
+    for (const auto& [from, to, distance] : pending_distances_) {
+        auto from_id = catalogue_.FindStopId(from);
+        auto to_id = catalogue_.FindStopId(to);
+        if (from_id && to_id) {
+            catalogue_.AddDistance(*from_id, *to_id, distance);
+        }
+    }
+
+    std::vector<StopId> bus_stop_ids;
+    bus_stop_ids.reserve(pending_bus_stops_.size());
+    for (std::string_view stop_name : pending_bus_stops_) {
+        auto stop_id = catalogue_.FindStopId(stop_name);
+        if (!stop_id.has_value()) {
+            throw std::invalid_argument("The bus stop "s + std::string(stop_name) + " is not found"s);
+        }
+        bus_stop_ids.push_back(*stop_id);
+    }
+    for (const PendingBus& bus : pending_buses_) {
+        catalogue_.AdoptBus({bus.name, {bus_stop_ids.data() + bus.stops_begin, bus_stop_ids.data() + bus.stops_end},
+                             bus.is_round});
+    }
+    catalogue_.Freeze();
+
+    pending_distances_.clear();
+    pending_buses_.clear();
+    pending_bus_stops_.clear();
+}
+
+} // transport_catalogue
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "domain.h"
+#include "transport_catalogue.h"
+
+namespace transport_catalogue {
+
+/*
+ * Пошаговая загрузка каталога по мере разбора входных данных, без промежуточного CatalogueData.
+ * Остановки добавляются сразу. Расстояния и автобусы, ссылающиеся на ещё не добавленные
+ * остановки, откладываются до Finish; автобусы получают идентификаторы в порядке поступления.
+ * Названия остановок и автобусов каталог принимает без копирования, поэтому строки AddStop
+ * и AddBus должны жить дольше каталога. Отложенные расстояния тоже хранят названия ссылками,
+ * поэтому строки AddDistance должны жить до Finish
+ */
+class CatalogueLoader {
+public:
+    explicit CatalogueLoader(TransportCatalogue& catalogue);
+
+    void AddStop(const Stop& stop);
+    void AddDistance(std::string_view from, std::string_view to, int distance);
+    void AddBus(std::string_view name, const std::vector<std::string_view>& stops, bool is_round);
+    // Добавляет отложенное и замораживает каталог. Расстояние, у которого одна из остановок
+    // так и не была добавлена, молча пропускается. Выбрасывает std::invalid_argument,
+    // если маршрут ссылается на неизвестную остановку
+    void Finish();
+
+private:
+    struct PendingDistance {
+        std::string_view from;
+        std::string_view to;
+        int distance;
+    };
+
+    struct PendingBus {
+        std::string_view name;
+        // Остановки маршрута — полуинтервал [stops_begin, stops_end) массива pending_bus_stops_
+        size_t stops_begin;
+        size_t stops_end;
+        bool is_round;
+    };
+
+    TransportCatalogue& catalogue_;
+    std::vector<PendingDistance> pending_distances_;
+    std::vector<PendingBus> pending_buses_;
+    std::vector<std::string_view> pending_bus_stops_;
+    // Идентификаторы остановок маршрута, добавляемого сразу
+    std::vector<StopId> stop_ids_;
+};
+
+} // transport_catalogue
\ No newline at end of file
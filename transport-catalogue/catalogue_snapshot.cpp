@@ -0,0 +1,185 @@
+#include "catalogue_snapshot.h"
+
+#include <thread>
+#include <utility>
+
+namespace transport_catalogue {
+
+CatalogueSnapshot::CatalogueSnapshot(const TransportCatalogue& builder, const transport_router::RouterSettings& settings,
+                                     uint64_t version)
+    : catalogue_(CopyCatalogue(builder))
+    , router_(*catalogue_, settings)
+    , version_(version) {
+}
+
+CatalogueSnapshot::CatalogueSnapshot(std::unique_ptr<TransportCatalogue> catalogue,
+                                     const transport_router::RouterSettings& settings, uint64_t version)
+    : catalogue_(FreezeCatalogue(std::move(catalogue)))
+    , router_(*catalogue_, settings)
+    , version_(version) {
+}
+
+CatalogueSnapshot::CatalogueSnapshot(std::unique_ptr<TransportCatalogue> catalogue,
+                                     transport_router::TransportRouter::State router_state, uint64_t version)
+    : catalogue_(FreezeCatalogue(std::move(catalogue)))
+    , router_(*catalogue_, std::move(router_state))
+    , version_(version) {
+}
+
+const TransportCatalogue& CatalogueSnapshot::GetCatalogue() const {
+    return *catalogue_;
+}
+
+const transport_router::TransportRouter& CatalogueSnapshot::GetRouter() const {
+    return router_;
+}
+
+uint64_t CatalogueSnapshot::GetVersion() const {
+    return version_;
+}
+
+std::unique_ptr<TransportCatalogue> CatalogueSnapshot::CopyCatalogue(const TransportCatalogue& builder) {
+    auto catalogue = std::make_unique<TransportCatalogue>();
+    catalogue->CopyFrom(builder);
+    return catalogue;
+}
+
+std::unique_ptr<TransportCatalogue> CatalogueSnapshot::FreezeCatalogue(std::unique_ptr<TransportCatalogue> catalogue) {
+    catalogue->Freeze();
+    return catalogue;
+}
+
+SnapshotStore::Pin::Pin(std::atomic<uint64_t>* readers, const CatalogueSnapshot* snapshot)
+    : readers_(readers)
+    , snapshot_(snapshot) {
+}
+
+SnapshotStore::Pin::Pin(Pin&& other) noexcept
+    : readers_(std::exchange(other.readers_, nullptr))
+    , snapshot_(std::exchange(other.snapshot_, nullptr)) {
+}
+
+SnapshotStore::Pin& SnapshotStore::Pin::operator=(Pin&& other) noexcept {
+    if (this != &other) {
+        Release();
+        readers_ = std::exchange(other.readers_, nullptr);
+        snapshot_ = std::exchange(other.snapshot_, nullptr);
+    }
+    return *this;
+}
+
+SnapshotStore::Pin::~Pin() {
+    Release();
+}
+
+const CatalogueSnapshot* SnapshotStore::Pin::get() const {
+    return snapshot_;
+}
+
+const CatalogueSnapshot& SnapshotStore::Pin::operator*() const {
+    return *snapshot_;
+}
+
+const CatalogueSnapshot* SnapshotStore::Pin::operator->() const {
+    return snapshot_;
+}
+
+SnapshotStore::Pin::operator bool() const {
+    return snapshot_ != nullptr;
+}
+
+void SnapshotStore::Pin::Release() {
+    if (readers_ != nullptr) {
+        readers_->fetch_sub(1, std::memory_order_release);
+        readers_ = nullptr;
+        snapshot_ = nullptr;
+    }
+}
+
+SnapshotStore::~SnapshotStore() {
+    for (Slot& slot : slots_) {
+        delete slot.snapshot.load(std::memory_order_relaxed);
+    }
+}
+
+SnapshotStore::Pin SnapshotStore::Acquire() const {
+    // Все операции с current_ и счётчиками читателей последовательно согласованы: если после
+    // увеличения счётчика ячейка всё ещё текущая, писатель, сменивший её позже, увидит читателя
+    while (true) {
+        const size_t index = current_.load();
+        if (index == NO_SLOT) {
+            return {};
+        }
+        Slot& slot = slots_[index];
+        slot.readers.fetch_add(1);
+        if (current_.load() == index) {
+            return {&slot.readers, slot.snapshot.load(std::memory_order_acquire)};
+        }
+        slot.readers.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+bool SnapshotStore::Publish(SnapshotPtr snapshot) {
+    if (!snapshot) {
+        return false;
+    }
+    std::lock_guard guard(publish_mutex_);
+    // Снимки, построенные в фоне, могут завершиться не по порядку: более старый не заменяет новый
+    const size_t current = current_.load();
+    if (current != NO_SLOT
+        && slots_[current].snapshot.load(std::memory_order_relaxed)->GetVersion() >= snapshot->GetVersion()) {
+        return false;
+    }
+    // Свободная ячейка — нетекущая, без читателей и без снимка; её снимок уже освобождён
+    while (true) {
+        ReclaimSlots();
+        for (size_t index = 0; index < SLOT_COUNT; ++index) {
+            Slot& slot = slots_[index];
+            if (index != current && slot.snapshot.load(std::memory_order_relaxed) == nullptr) {
+                slot.snapshot.store(snapshot.release(), std::memory_order_release);
+                current_.store(index);
+                ReclaimSlots();
+                return true;
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+SnapshotStore::SnapshotPtr SnapshotStore::Build(const TransportCatalogue& builder,
+                                                const transport_router::RouterSettings& settings) {
+    return std::make_unique<const CatalogueSnapshot>(builder, settings, next_version_.fetch_add(1));
+}
+
+SnapshotStore::SnapshotPtr SnapshotStore::Build(std::unique_ptr<TransportCatalogue> catalogue,
+                                                const transport_router::RouterSettings& settings) {
+    return std::make_unique<const CatalogueSnapshot>(std::move(catalogue), settings, next_version_.fetch_add(1));
+}
+
+SnapshotStore::SnapshotPtr SnapshotStore::Build(std::unique_ptr<TransportCatalogue> catalogue,
+                                                transport_router::TransportRouter::State router_state) {
+    return std::make_unique<const CatalogueSnapshot>(std::move(catalogue), std::move(router_state),
+                                                     next_version_.fetch_add(1));
+}
+
+std::future<bool> SnapshotStore::PublishAsync(const TransportCatalogue& builder,
+                                              transport_router::RouterSettings settings) {
+    // Номер выдаётся в момент вызова, чтобы порядок снимков совпадал с порядком обновлений построителя
+    const uint64_t version = next_version_.fetch_add(1);
+    return std::async(std::launch::async, [this, &builder, settings = std::move(settings), version] {
+        return Publish(std::make_unique<const CatalogueSnapshot>(builder, settings, version));
+    });
+}
+
+void SnapshotStore::ReclaimSlots() {
+    const size_t current = current_.load();
+    for (size_t index = 0; index < SLOT_COUNT; ++index) {
+        Slot& slot = slots_[index];
+        // Читатель, увеличивший счётчик позже этой проверки, увидит смену текущей ячейки и отступит
+        if (index != current && slot.readers.load() == 0) {
+            delete slot.snapshot.exchange(nullptr, std::memory_order_acq_rel);
+        }
+    }
+}
+
+} // transport_catalogue
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+namespace transport_catalogue {
+
+/*
+ * Неизменяемый снимок каталога вместе с построенным по нему маршрутизатором.
+ * Снимок копирует данные построителя в собственный компактный каталог и после создания
+ * не меняется, поэтому читатели обращаются к нему из любых потоков без синхронизации
+ */
+class CatalogueSnapshot {
+public:
+    CatalogueSnapshot(const TransportCatalogue& builder, const transport_router::RouterSettings& settings,
+                      uint64_t version);
+    // Забирает каталог без копирования; после этого его никто не изменяет
+    CatalogueSnapshot(std::unique_ptr<TransportCatalogue> catalogue, const transport_router::RouterSettings& settings,
+                      uint64_t version);
+    // Забирает каталог и восстанавливает сохранённый для него маршрутизатор без предобработки
+    CatalogueSnapshot(std::unique_ptr<TransportCatalogue> catalogue, transport_router::TransportRouter::State router_state,
+                      uint64_t version);
+    CatalogueSnapshot(const CatalogueSnapshot&) = delete;
+    CatalogueSnapshot& operator=(const CatalogueSnapshot&) = delete;
+
+    const TransportCatalogue& GetCatalogue() const;
+    const transport_router::TransportRouter& GetRouter() const;
+    // Номер снимка; более поздние снимки имеют бóльшие номера
+    uint64_t GetVersion() const;
+
+private:
+    std::unique_ptr<TransportCatalogue> catalogue_;
+    transport_router::TransportRouter router_;
+    uint64_t version_;
+
+    static std::unique_ptr<TransportCatalogue> CopyCatalogue(const TransportCatalogue& builder);
+    static std::unique_ptr<TransportCatalogue> FreezeCatalogue(std::unique_ptr<TransportCatalogue> catalogue);
+};
+
+/*
+ * Текущий снимок в стиле RCU без блокировок на стороне читателя. Снимки лежат в небольшом
+ * массиве ячеек, у каждой ячейки — счётчик закрепивших её читателей. Читатель увеличивает
+ * счётчик текущей ячейки и проверяет, что она всё ещё текущая; иначе отпускает её и повторяет.
+ * Писатель переключает номер текущей ячейки и освобождает снимки в ячейках без читателей.
+ * Чтение не ждёт ни писателя, ни мьютекса; писатель ждёт, только если все нетекущие ячейки
+ * закреплены читателями старых снимков
+ */
+class SnapshotStore {
+public:
+    using SnapshotPtr = std::unique_ptr<const CatalogueSnapshot>;
+
+    // Закреплённый снимок: пока объект жив, снимок не освобождается
+    class Pin {
+    public:
+        Pin() = default;
+        Pin(Pin&& other) noexcept;
+        Pin& operator=(Pin&& other) noexcept;
+        ~Pin();
+
+        const CatalogueSnapshot* get() const;
+        const CatalogueSnapshot& operator*() const;
+        const CatalogueSnapshot* operator->() const;
+        explicit operator bool() const;
+
+    private:
+        friend class SnapshotStore;
+
+        Pin(std::atomic<uint64_t>* readers, const CatalogueSnapshot* snapshot);
+        void Release();
+
+        std::atomic<uint64_t>* readers_ = nullptr;
+        const CatalogueSnapshot* snapshot_ = nullptr;
+    };
+
+    SnapshotStore() = default;
+    SnapshotStore(const SnapshotStore&) = delete;
+    SnapshotStore& operator=(const SnapshotStore&) = delete;
+    // Закреплённых снимков к этому моменту быть не должно
+    ~SnapshotStore();
+
+    // Текущий снимок или пустой Pin, если ничего не опубликовано
+    Pin Acquire() const;
+    // Публикует снимок, если он новее текущего; возвращает true при замене
+    bool Publish(SnapshotPtr snapshot);
+    // Строит снимок построителя с очередным номером синхронно
+    SnapshotPtr Build(const TransportCatalogue& builder, const transport_router::RouterSettings& settings);
+    SnapshotPtr Build(std::unique_ptr<TransportCatalogue> catalogue, const transport_router::RouterSettings& settings);
+    SnapshotPtr Build(std::unique_ptr<TransportCatalogue> catalogue, transport_router::TransportRouter::State router_state);
+    // Строит и публикует снимок в фоновом потоке. Построитель нельзя изменять и удалять,
+    // пока future не готов; читатели продолжают работать с прежним снимком
+    std::future<bool> PublishAsync(const TransportCatalogue& builder, transport_router::RouterSettings settings);
+
+private:
+    static constexpr size_t SLOT_COUNT = 4;
+    static constexpr size_t NO_SLOT = SLOT_COUNT;
+
+    struct Slot {
+        std::atomic<const CatalogueSnapshot*> snapshot{nullptr};
+        std::atomic<uint64_t> readers{0};
+    };
+
+    mutable std::array<Slot, SLOT_COUNT> slots_;
+    std::atomic<size_t> current_{NO_SLOT};
+    // Публикации выполняются по одной
+    std::mutex publish_mutex_;
+    std::atomic<uint64_t> next_version_{1};
+
+    // Освобождает снимки в нетекущих ячейках без читателей
+    void ReclaimSlots();
+};
+
+} // transport_catalogue
\ No newline at end of file
@@ -0,0 +1,534 @@
+#pragma once
+
+#include "graph.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/*
+ * Маршрутизатор в стиле Customizable Route Planning.
+ * Предобработка состоит из двух фаз:
+ *  - многоуровневое разбиение графа на вложенные ячейки, не зависящее от весов рёбер
+ *    (выполняется один раз в конструкторе);
+ *  - кастомизация: для каждой ячейки вычисляются кратчайшие расстояния между её
+ *    входными и выходными вершинами (перезапускается методом Customize после изменения весов).
+ * Запрос выполняет поиск Дейкстры по оверлею: вблизи начальной и конечной вершин используются
+ * рёбра исходного графа, вдали от них — клики ячеек самого высокого подходящего уровня.
+ */
+template <typename Weight>
+class CrpRouter {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+    using CellId = uint32_t;
+
+public:
+    struct PartitionSettings {
+        // Максимальное число вершин в ячейке первого уровня
+        size_t cell_size = 32;
+        // Во сколько раз ячейка следующего уровня больше ячейки предыдущего
+        size_t level_ratio = 8;
+        size_t level_count = 3;
+    };
+
+    struct RouteInfo {
+        Weight weight;
+        std::vector<EdgeId> edges;
+    };
+
+    // Начальная или конечная вершина с дополнительным весом пути до неё (от неё)
+    struct Endpoint {
+        VertexId vertex;
+        Weight weight;
+    };
+
+    struct EndpointsRouteInfo {
+        Weight weight;
+        size_t source;
+        size_t target;
+        std::vector<EdgeId> edges;
+    };
+
+    // Разбиение и клики ячеек — всё, что вычисляет предобработка. Сохраняется вместе с графом,
+    // чтобы восстановить маршрутизатор без разбиения и кастомизации
+    struct Overlay {
+        // vertex_cells[i][v] — ячейка вершины v на уровне i + 1
+        std::vector<std::vector<uint32_t>> vertex_cells;
+        // Клики ячеек подряд: по уровням, внутри уровня — по номерам ячеек
+        std::vector<std::optional<Weight>> cliques;
+    };
+
+    explicit CrpRouter(const Graph& graph);
+    CrpRouter(const Graph& graph, const PartitionSettings& settings);
+    // Восстанавливает маршрутизатор по оверлею, полученному GetOverlay для того же графа с теми же весами.
+    // Выбрасывает std::invalid_argument, если оверлей не согласован с графом
+    CrpRouter(const Graph& graph, const Overlay& overlay);
+
+    // Пересчитывает клики всех ячеек по текущим весам рёбер графа
+    void Customize();
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+    // Кратчайший маршрут от любой из начальных вершин до любой из конечных за один поиск.
+    // Вес маршрута включает веса выбранных начальной и конечной вершин
+    std::optional<EndpointsRouteInfo> BuildRoute(const std::vector<Endpoint>& sources,
+                                                 const std::vector<Endpoint>& targets) const;
+    Overlay GetOverlay() const;
+    memory_stats::MemoryStats GetMemoryStats() const;
+
+private:
+    static constexpr uint32_t NO_INDEX = UINT32_MAX;
+    static constexpr Weight ZERO_WEIGHT{};
+
+    struct Cell {
+        std::vector<VertexId> entries;
+        std::vector<VertexId> exits;
+        // Матрица entries.size() x exits.size() кратчайших расстояний внутри ячейки
+        std::vector<std::optional<Weight>> clique;
+    };
+
+    struct Level {
+        std::vector<CellId> vertex_cell;
+        std::vector<uint32_t> entry_index;
+        std::vector<uint32_t> exit_index;
+        std::vector<Cell> cells;
+    };
+
+    // Дуга поисковой сети: ребро графа (level == 0) или дуга клики ячейки уровня level
+    struct Arc {
+        size_t level;
+        EdgeId edge;
+        VertexId from;
+        VertexId to;
+    };
+
+    struct Label {
+        Weight weight;
+        std::optional<Arc> prev_arc;
+    };
+
+    using Labels = std::unordered_map<VertexId, Label>;
+
+    const Graph& graph_;
+    // levels_[i] описывает разбиение уровня i + 1, ячейки уровня вложены в ячейки следующего
+    std::vector<Level> levels_;
+
+    static std::vector<CellId> GrowRegions(const std::vector<std::vector<size_t>>& neighbours,
+                                           const std::vector<size_t>& sizes, size_t max_size) {
+        std::vector<CellId> result(neighbours.size(), NO_INDEX);
+        CellId next_cell = 0;
+        for (size_t seed = 0; seed < neighbours.size(); ++seed) {
+            if (result[seed] != NO_INDEX) {
+                continue;
+            }
+            size_t cell_size = sizes[seed];
+            result[seed] = next_cell;
+            std::queue<size_t> queue;
+            queue.push(seed);
+            while (!queue.empty()) {
+                const size_t node = queue.front();
+                queue.pop();
+                for (const size_t neighbour : neighbours[node]) {
+                    if (result[neighbour] == NO_INDEX && cell_size + sizes[neighbour] <= max_size) {
+                        result[neighbour] = next_cell;
+                        cell_size += sizes[neighbour];
+                        queue.push(neighbour);
+                    }
+                }
+            }
+            ++next_cell;
+        }
+        return result;
+    }
+
+    void BuildLevelBoundaries(Level& level, size_t cell_count) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+        level.cells.resize(cell_count);
+        level.entry_index.assign(vertex_count, NO_INDEX);
+        level.exit_index.assign(vertex_count, NO_INDEX);
+        for (EdgeId edge_id = 0; edge_id < graph_.GetEdgeCount(); ++edge_id) {
+            const auto& edge = graph_.GetEdge(edge_id);
+            const CellId cell_from = level.vertex_cell[edge.from];
+            const CellId cell_to = level.vertex_cell[edge.to];
+            if (cell_from == cell_to) {
+                continue;
+            }
+            if (level.exit_index[edge.from] == NO_INDEX) {
+                auto& exits = level.cells[cell_from].exits;
+                level.exit_index[edge.from] = static_cast<uint32_t>(exits.size());
+                exits.push_back(edge.from);
+            }
+            if (level.entry_index[edge.to] == NO_INDEX) {
+                auto& entries = level.cells[cell_to].entries;
+                level.entry_index[edge.to] = static_cast<uint32_t>(entries.size());
+                entries.push_back(edge.to);
+            }
+        }
+    }
+
+    void BuildPartition(const PartitionSettings& settings) {
+        const size_t vertex_count = graph_.GetVertexCount();
+
+        // На каждом уровне разбиение строится над графом ячеек предыдущего уровня
+        std::vector<std::vector<size_t>> neighbours(vertex_count);
+        for (EdgeId edge_id = 0; edge_id < graph_.GetEdgeCount(); ++edge_id) {
+            const auto& edge = graph_.GetEdge(edge_id);
+            if (edge.from != edge.to) {
+                neighbours[edge.from].push_back(edge.to);
+                neighbours[edge.to].push_back(edge.from);
+            }
+        }
+        std::vector<size_t> sizes(vertex_count, 1);
+        std::vector<size_t> vertex_node(vertex_count);
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            vertex_node[vertex] = vertex;
+        }
+
+        size_t max_size = std::max<size_t>(settings.cell_size, 1);
+        for (size_t level_index = 0; level_index < settings.level_count; ++level_index) {
+            const std::vector<CellId> node_cell = GrowRegions(neighbours, sizes, max_size);
+            const size_t cell_count = node_cell.empty() ? 0 : *std::max_element(node_cell.begin(), node_cell.end()) + 1;
+            // Уровень из одной ячейки не имеет границ, а уровень без слияний повторяет предыдущий
+            if (cell_count <= 1 || (level_index > 0 && cell_count == neighbours.size())) {
+                break;
+            }
+
+            Level level;
+            level.vertex_cell.resize(vertex_count);
+            for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+                vertex_node[vertex] = node_cell[vertex_node[vertex]];
+                level.vertex_cell[vertex] = static_cast<CellId>(vertex_node[vertex]);
+            }
+            BuildLevelBoundaries(level, cell_count);
+            levels_.push_back(std::move(level));
+
+            std::vector<std::vector<size_t>> cell_neighbours(cell_count);
+            std::vector<size_t> cell_sizes(cell_count, 0);
+            for (size_t node = 0; node < neighbours.size(); ++node) {
+                cell_sizes[node_cell[node]] += sizes[node];
+                for (const size_t neighbour : neighbours[node]) {
+                    if (node_cell[node] != node_cell[neighbour]) {
+                        cell_neighbours[node_cell[node]].push_back(node_cell[neighbour]);
+                    }
+                }
+            }
+            for (auto& list : cell_neighbours) {
+                std::sort(list.begin(), list.end());
+                list.erase(std::unique(list.begin(), list.end()), list.end());
+            }
+            neighbours = std::move(cell_neighbours);
+            sizes = std::move(cell_sizes);
+            max_size *= std::max<size_t>(settings.level_ratio, 2);
+        }
+    }
+
+    // Число уровней, на которых ячейка вершины отличается от ячеек всех начальных и конечных вершин.
+    // endpoint_cells[i] — отсортированные ячейки этих вершин на уровне i + 1
+    size_t GetQueryLevel(VertexId vertex, const std::vector<std::vector<CellId>>& endpoint_cells) const {
+        size_t level = 0;
+        for (; level < levels_.size(); ++level) {
+            const auto& cells = endpoint_cells[level];
+            if (std::binary_search(cells.begin(), cells.end(), levels_[level].vertex_cell[vertex])) {
+                break;
+            }
+        }
+        return level;
+    }
+
+    // Перебирает дуги поисковой сети уровня level, выходящие из вершины.
+    // Если bound_level > 0, рассматриваются только дуги внутри ячейки bound_cell уровня bound_level.
+    template <typename Callback>
+    void ForEachArc(VertexId vertex, size_t level, size_t bound_level, CellId bound_cell, Callback callback) const {
+        auto is_inside = [this, bound_level, bound_cell](VertexId other) {
+            return bound_level == 0 || levels_[bound_level - 1].vertex_cell[other] == bound_cell;
+        };
+
+        if (level == 0) {
+            for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                const auto& edge = graph_.GetEdge(edge_id);
+                if (is_inside(edge.to)) {
+                    callback(Arc{0, edge_id, vertex, edge.to}, edge.weight);
+                }
+            }
+            return;
+        }
+
+        const Level& current = levels_[level - 1];
+        const CellId cell_id = current.vertex_cell[vertex];
+        const Cell& cell = current.cells[cell_id];
+        if (const uint32_t entry = current.entry_index[vertex]; entry != NO_INDEX) {
+            const size_t exit_count = cell.exits.size();
+            for (size_t exit = 0; exit < exit_count; ++exit) {
+                const auto& weight = cell.clique[entry * exit_count + exit];
+                if (weight && cell.exits[exit] != vertex) {
+                    callback(Arc{level, 0, vertex, cell.exits[exit]}, *weight);
+                }
+            }
+        }
+        if (current.exit_index[vertex] != NO_INDEX) {
+            for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                const auto& edge = graph_.GetEdge(edge_id);
+                if (current.vertex_cell[edge.to] != cell_id && is_inside(edge.to)) {
+                    callback(Arc{0, edge_id, vertex, edge.to}, edge.weight);
+                }
+            }
+        }
+    }
+
+    // Поиск Дейкстры; settle вызывается для каждой окончательно обработанной вершины и может остановить поиск
+    template <typename Expand, typename Settle>
+    Labels Search(const std::vector<Endpoint>& sources, Expand expand, Settle settle) const {
+        using QueueItem = std::pair<Weight, VertexId>;
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+        Labels labels;
+        for (const auto& [vertex, weight] : sources) {
+            auto [it, inserted] = labels.try_emplace(vertex, Label{weight, std::nullopt});
+            if (inserted || weight < it->second.weight) {
+                it->second.weight = weight;
+                queue.push({weight, vertex});
+            }
+        }
+        while (!queue.empty()) {
+            const auto [weight, vertex] = queue.top();
+            queue.pop();
+            if (labels.at(vertex).weight < weight) {
+                continue;
+            }
+            if (settle(vertex, weight)) {
+                break;
+            }
+            expand(vertex, [&labels, &queue, weight = weight](const Arc& arc, Weight arc_weight) {
+                const Weight candidate = weight + arc_weight;
+                auto [it, inserted] = labels.try_emplace(arc.to, Label{candidate, arc});
+                if (inserted || candidate < it->second.weight) {
+                    it->second = Label{candidate, arc};
+                    queue.push({candidate, arc.to});
+                }
+            });
+        }
+        return labels;
+    }
+
+    template <typename Expand>
+    Labels Search(VertexId from, std::optional<VertexId> to, Expand expand) const {
+        return Search({Endpoint{from, ZERO_WEIGHT}}, expand, [to](VertexId vertex, Weight) {
+            return to && vertex == *to;
+        });
+    }
+
+    static std::vector<Arc> CollectArcs(const Labels& labels, VertexId to) {
+        std::vector<Arc> arcs;
+        for (auto arc = labels.at(to).prev_arc; arc; arc = labels.at(arc->from).prev_arc) {
+            arcs.push_back(*arc);
+        }
+        std::reverse(arcs.begin(), arcs.end());
+        return arcs;
+    }
+
+    // Раскрывает дугу клики в последовательность рёбер исходного графа
+    void UnpackArc(const Arc& arc, std::vector<EdgeId>& edges) const {
+        if (arc.level == 0) {
+            edges.push_back(arc.edge);
+            return;
+        }
+        const CellId cell = levels_[arc.level - 1].vertex_cell[arc.from];
+        const size_t level = arc.level - 1;
+        const Labels labels = Search(arc.from, arc.to, [this, level, &arc, cell](VertexId vertex, auto relax) {
+            ForEachArc(vertex, level, arc.level, cell, relax);
+        });
+        for (const Arc& inner_arc : CollectArcs(labels, arc.to)) {
+            UnpackArc(inner_arc, edges);
+        }
+    }
+};
+
+template <typename Weight>
+CrpRouter<Weight>::CrpRouter(const Graph& graph)
+    : CrpRouter(graph, PartitionSettings{}) {
+}
+
+template <typename Weight>
+CrpRouter<Weight>::CrpRouter(const Graph& graph, const PartitionSettings& settings)
+    : graph_(graph) {
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+    BuildPartition(settings);
+    Customize();
+}
+
+template <typename Weight>
+CrpRouter<Weight>::CrpRouter(const Graph& graph, const Overlay& overlay)
+    : graph_(graph) {
+    const size_t vertex_count = graph.GetVertexCount();
+    auto clique = overlay.cliques.begin();
+    for (const auto& vertex_cell : overlay.vertex_cells) {
+        if (vertex_cell.size() != vertex_count) {
+            throw std::invalid_argument("Overlay levels do not match the graph");
+        }
+        Level level;
+        level.vertex_cell = vertex_cell;
+        const size_t cell_count = vertex_count == 0 ? 0 : *std::max_element(vertex_cell.begin(), vertex_cell.end()) + 1;
+        if (cell_count > vertex_count) {
+            throw std::invalid_argument("Overlay levels do not match the graph");
+        }
+        // Входы и выходы ячеек не зависят от весов и перечисляются в том же порядке, что и при разбиении
+        BuildLevelBoundaries(level, cell_count);
+        for (Cell& cell : level.cells) {
+            const size_t size = cell.entries.size() * cell.exits.size();
+            if (static_cast<size_t>(overlay.cliques.end() - clique) < size) {
+                throw std::invalid_argument("Overlay cliques do not match the graph");
+            }
+            cell.clique.assign(clique, clique + size);
+            clique += size;
+        }
+        levels_.push_back(std::move(level));
+    }
+    if (clique != overlay.cliques.end()) {
+        throw std::invalid_argument("Overlay cliques do not match the graph");
+    }
+}
+
+template <typename Weight>
+void CrpRouter<Weight>::Customize() {
+    for (size_t level = 1; level <= levels_.size(); ++level) {
+        auto& cells = levels_[level - 1].cells;
+        for (CellId cell_id = 0; cell_id < cells.size(); ++cell_id) {
+            Cell& cell = cells[cell_id];
+            const size_t exit_count = cell.exits.size();
+            cell.clique.assign(cell.entries.size() * exit_count, std::nullopt);
+            for (size_t entry = 0; entry < cell.entries.size(); ++entry) {
+                const Labels labels = Search(cell.entries[entry], std::nullopt,
+                                             [this, level, cell_id](VertexId vertex, auto relax) {
+                    ForEachArc(vertex, level - 1, level, cell_id, relax);
+                });
+                for (size_t exit = 0; exit < exit_count; ++exit) {
+                    if (auto it = labels.find(cell.exits[exit]); it != labels.end()) {
+                        cell.clique[entry * exit_count + exit] = it->second.weight;
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename Weight>
+std::optional<typename CrpRouter<Weight>::RouteInfo> CrpRouter<Weight>::BuildRoute(VertexId from,
+                                                                                   VertexId to) const {
+    auto route = BuildRoute(std::vector<Endpoint>{{from, ZERO_WEIGHT}}, std::vector<Endpoint>{{to, ZERO_WEIGHT}});
+    if (!route) {
+        return std::nullopt;
+    }
+    return RouteInfo{route->weight, std::move(route->edges)};
+}
+
+template <typename Weight>
+std::optional<typename CrpRouter<Weight>::EndpointsRouteInfo> CrpRouter<Weight>::BuildRoute(
+        const std::vector<Endpoint>& sources, const std::vector<Endpoint>& targets) const {
+    std::vector<std::vector<CellId>> endpoint_cells(levels_.size());
+    for (const auto* endpoints : {&sources, &targets}) {
+        for (const Endpoint& endpoint : *endpoints) {
+            if (endpoint.vertex >= graph_.GetVertexCount()) {
+                throw std::out_of_range("Vertex is out of range");
+            }
+            for (size_t level = 0; level < levels_.size(); ++level) {
+                endpoint_cells[level].push_back(levels_[level].vertex_cell[endpoint.vertex]);
+            }
+        }
+    }
+    for (auto& cells : endpoint_cells) {
+        std::sort(cells.begin(), cells.end());
+        cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+    }
+
+    std::unordered_map<VertexId, size_t> target_indices;
+    for (size_t i = 0; i < targets.size(); ++i) {
+        auto [it, inserted] = target_indices.try_emplace(targets[i].vertex, i);
+        if (!inserted && targets[i].weight < targets[it->second].weight) {
+            it->second = i;
+        }
+    }
+
+    // Поиск останавливается, когда вес очередной вершины не меньше лучшего найденного маршрута
+    std::optional<std::pair<Weight, size_t>> best;
+    const Labels labels = Search(sources,
+        [this, &endpoint_cells](VertexId vertex, auto relax) {
+            ForEachArc(vertex, GetQueryLevel(vertex, endpoint_cells), 0, 0, relax);
+        },
+        [&best, &target_indices, &targets](VertexId vertex, Weight weight) {
+            if (best && !(weight < best->first)) {
+                return true;
+            }
+            if (auto it = target_indices.find(vertex); it != target_indices.end()) {
+                const Weight candidate = weight + targets[it->second].weight;
+                if (!best || candidate < best->first) {
+                    best = {candidate, it->second};
+                }
+            }
+            return false;
+        });
+    if (!best) {
+        return std::nullopt;
+    }
+
+    const VertexId to = targets[best->second].vertex;
+    const std::vector<Arc> arcs = CollectArcs(labels, to);
+    const VertexId from = arcs.empty() ? to : arcs.front().from;
+    size_t source = 0;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (sources[i].vertex == from && (sources[source].vertex != from || sources[i].weight < sources[source].weight)) {
+            source = i;
+        }
+    }
+
+    std::vector<EdgeId> edges;
+    for (const Arc& arc : arcs) {
+        UnpackArc(arc, edges);
+    }
+    return EndpointsRouteInfo{best->first, source, best->second, std::move(edges)};
+}
+
+template <typename Weight>
+typename CrpRouter<Weight>::Overlay CrpRouter<Weight>::GetOverlay() const {
+    Overlay overlay;
+    for (const Level& level : levels_) {
+        overlay.vertex_cells.push_back(level.vertex_cell);
+        for (const Cell& cell : level.cells) {
+            overlay.cliques.insert(overlay.cliques.end(), cell.clique.begin(), cell.clique.end());
+        }
+    }
+    return overlay;
+}
+
+template <typename Weight>
+memory_stats::MemoryStats CrpRouter<Weight>::GetMemoryStats() const {
+    using memory_stats::GetVectorUsage;
+    memory_stats::Usage vertex_cells, cells, boundaries, cliques;
+    for (const Level& level : levels_) {
+        vertex_cells += GetVectorUsage(level.vertex_cell);
+        boundaries.bytes += GetVectorUsage(level.entry_index).bytes + GetVectorUsage(level.exit_index).bytes;
+        cells += GetVectorUsage(level.cells);
+        for (const Cell& cell : level.cells) {
+            boundaries += GetVectorUsage(cell.entries);
+            boundaries += GetVectorUsage(cell.exits);
+            cliques += GetVectorUsage(cell.clique);
+        }
+    }
+    memory_stats::MemoryStats stats;
+    stats.Add("vertex_cells", vertex_cells);
+    stats.Add("cells", cells);
+    stats.Add("boundaries", boundaries);
+    stats.Add("cliques", cliques);
+    return stats;
+}
+
+}  // namespace graph
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "distance_table.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace transport_catalogue {
+
+namespace {
+
+constexpr size_t MIN_CAPACITY = 16;
+
+// Максимальная заполненность таблицы — 3/4
+bool IsOverloaded(size_t size, size_t capacity) {
+    return size * 4 > capacity * 3;
+}
+
+} // namespace
+
+bool DistanceTable::Set(StopId from, StopId to, int distance) {
+    if (IsOverloaded(size_ + 1, slots_.size())) {
+        Rehash(std::max(MIN_CAPACITY, slots_.size() * 2));
+    }
+    const uint64_t key = MakeKey(from, to);
+    Slot& slot = slots_[FindSlot(key)];
+    if (slot.key == EMPTY_KEY) {
+        slot.key = key;
+        ++size_;
+    }
+    int32_t& value = from <= to ? slot.forward : slot.backward;
+    if (value == distance) {
+        return false;
+    }
+    value = distance;
+    return true;
+}
+
+std::optional<int> DistanceTable::Get(StopId from, StopId to) const {
+    if (slots_.empty()) {
+        return std::nullopt;
+    }
+    const Slot& slot = slots_[FindSlot(MakeKey(from, to))];
+    if (slot.key == EMPTY_KEY) {
+        return std::nullopt;
+    }
+    const int32_t direct = from <= to ? slot.forward : slot.backward;
+    const int32_t reverse = from <= to ? slot.backward : slot.forward;
+    if (direct != NO_DISTANCE) {
+        return direct;
+    }
+    if (reverse != NO_DISTANCE) {
+        return reverse;
+    }
+    return std::nullopt;
+}
+
+bool DistanceTable::Erase(StopId from, StopId to) {
+    if (slots_.empty()) {
+        return false;
+    }
+    size_t index = FindSlot(MakeKey(from, to));
+    Slot& slot = slots_[index];
+    int32_t& value = from <= to ? slot.forward : slot.backward;
+    if (slot.key == EMPTY_KEY || value == NO_DISTANCE) {
+        return false;
+    }
+    value = NO_DISTANCE;
+    if (slot.forward != NO_DISTANCE || slot.backward != NO_DISTANCE) {
+        return true;
+    }
+
+    // Удаление со сдвигом назад: следующие ячейки цепочки переносятся в дыру, если она лежит
+    // между их начальной ячейкой и текущей позицией, поэтому надгробия не нужны
+    const size_t mask = slots_.size() - 1;
+    for (size_t next = (index + 1) & mask; slots_[next].key != EMPTY_KEY; next = (next + 1) & mask) {
+        const size_t home = GetHomeSlot(slots_[next].key);
+        if (((next - home) & mask) >= ((next - index) & mask)) {
+            slots_[index] = slots_[next];
+            index = next;
+        }
+    }
+    slots_[index] = Slot{};
+    --size_;
+    return true;
+}
+
+void DistanceTable::Reserve(size_t pair_count) {
+    size_t capacity = MIN_CAPACITY;
+    while (IsOverloaded(pair_count, capacity)) {
+        capacity *= 2;
+    }
+    if (capacity > slots_.size()) {
+        Rehash(capacity);
+    }
+}
+
+size_t DistanceTable::GetSize() const {
+    return size_;
+}
+
+size_t DistanceTable::GetCapacity() const {
+    return slots_.size();
+}
+
+DistanceTable::State DistanceTable::GetState() const {
+    return {slots_};
+}
+
+void DistanceTable::SetState(State state) {
+    const size_t capacity = state.slots.size();
+    const size_t size = std::count_if(state.slots.begin(), state.slots.end(), [](const Slot& slot) {
+        return slot.key != EMPTY_KEY;
+    });
+    if ((capacity & (capacity - 1)) != 0 || (capacity != 0 && capacity < MIN_CAPACITY) || IsOverloaded(size, capacity)) {
+        throw std::invalid_argument("Invalid distance table slots");
+    }
+    slots_ = std::move(state.slots);
+    size_ = size;
+}
+
+memory_stats::Usage DistanceTable::GetMemoryUsage() const {
+    return {size_, memory_stats::GetVectorUsage(slots_).bytes};
+}
+
+uint64_t DistanceTable::MakeKey(StopId from, StopId to) {
+    if (from > to) {
+        std::swap(from, to);
+    }
+    return static_cast<uint64_t>(from) << 32 | to;
+}
+
+size_t DistanceTable::GetHomeSlot(uint64_t key) const {
+    // Мультипликативное хеширование Фибоначчи: старшие биты произведения хорошо перемешаны
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & (slots_.size() - 1);
+}
+
+size_t DistanceTable::FindSlot(uint64_t key) const {
+    const size_t mask = slots_.size() - 1;
+    size_t index = GetHomeSlot(key);
+    while (slots_[index].key != EMPTY_KEY && slots_[index].key != key) {
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+void DistanceTable::Rehash(size_t capacity) {
+    std::vector<Slot> old_slots(capacity);
+    std::swap(old_slots, slots_);
+    for (const Slot& slot : old_slots) {
+        if (slot.key != EMPTY_KEY) {
+            slots_[FindSlot(slot.key)] = slot;
+        }
+    }
+}
+
+} // transport_catalogue
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "domain.h"
+#include "memory_stats.h"
+
+namespace transport_catalogue {
+
+/*
+ * Хеш-таблица с открытой адресацией для дорожных расстояний между остановками.
+ * Ключ — упакованная в 64 бита неупорядоченная пара идентификаторов, поэтому расстояния
+ * в прямом и обратном направлениях хранятся в одной ячейке и находятся за один проход
+ * по последовательности проб
+ */
+class DistanceTable {
+public:
+    static constexpr uint64_t EMPTY_KEY = std::numeric_limits<uint64_t>::max();
+    static constexpr int32_t NO_DISTANCE = std::numeric_limits<int32_t>::min();
+
+    struct Slot {
+        uint64_t key = EMPTY_KEY;
+        // Расстояния от меньшего идентификатора к большему и обратно
+        int32_t forward = NO_DISTANCE;
+        int32_t backward = NO_DISTANCE;
+    };
+
+    // Ячейки таблицы как есть: сохраняются в снимок и восстанавливаются без перехеширования
+    struct State {
+        std::vector<Slot> slots;
+    };
+
+    // Возвращает true, если значение добавлено или изменилось
+    bool Set(StopId from, StopId to, int distance);
+    // Расстояние от from до to, а если оно не задано — от to до from
+    std::optional<int> Get(StopId from, StopId to) const;
+    // Удаляет расстояние от from до to; возвращает false, если его не было
+    bool Erase(StopId from, StopId to);
+    void Reserve(size_t pair_count);
+    // Число заполненных ячеек (пар остановок)
+    size_t GetSize() const;
+    size_t GetCapacity() const;
+    State GetState() const;
+    // Ячейки должны быть расставлены этой же таблицей. Выбрасывает std::invalid_argument,
+    // если число ячеек не степень двойки или таблица переполнена
+    void SetState(State state);
+    memory_stats::Usage GetMemoryUsage() const;
+    // Вызывает callback(from, to, distance) для каждого заданного расстояния
+    template <typename Callback>
+    void ForEach(Callback callback) const;
+
+private:
+    std::vector<Slot> slots_;
+    size_t size_ = 0;
+
+    static uint64_t MakeKey(StopId from, StopId to);
+    size_t GetHomeSlot(uint64_t key) const;
+    size_t FindSlot(uint64_t key) const;
+    void Rehash(size_t capacity);
+};
+
+template <typename Callback>
+void DistanceTable::ForEach(Callback callback) const {
+    for (const Slot& slot : slots_) {
+        if (slot.key == EMPTY_KEY) {
+            continue;
+        }
+        const auto low = static_cast<StopId>(slot.key >> 32);
+        const auto high = static_cast<StopId>(slot.key);
+        if (slot.forward != NO_DISTANCE) {
+            callback(low, high, slot.forward);
+        }
+        if (slot.backward != NO_DISTANCE) {
+            callback(high, low, slot.backward);
+        }
+    }
+}
+
+} // transport_catalogue
\ No newline at end of file
@@ -1,21 +1,103 @@
 #pragma once
 
-#include <string>
-#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
 
 #include "geo.h"
+#include "ranges.h"
 
 namespace transport_catalogue {
 
+// Плотные идентификаторы, выдаваемые каталогом в порядке добавления
+using StopId = uint32_t;
+using BusId = uint32_t;
+
+// Названия и последовательности остановок хранятся в арене каталога,
+// при добавлении данные копируются туда из памяти вызывающего кода
 struct Stop {
-	std::string name;
+	std::string_view name;
 	geo::Coordinates coordinates;
 };
 
+/*
+ * Полный маршрут автобуса поверх хранимых остановок: для некольцевого маршрута
+ * за путём в одну сторону следует обратный путь без повтора конечной остановки
+ */
+class RouteView {
+public:
+	class Iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = StopId;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const StopId*;
+		using reference = StopId;
+
+		// Итератор хранит копию остановок и признак кольцевого маршрута, а не ссылку на RouteView,
+		// поэтому переживает временный RouteView, из которого получен
+		Iterator(ranges::Range<const StopId*> stops, bool is_round, size_t index)
+			: stops_(stops), is_round_(is_round), index_(index) {
+		}
+		StopId operator*() const {
+			return RouteView(stops_, is_round_)[index_];
+		}
+		Iterator& operator++() {
+			++index_;
+			return *this;
+		}
+		Iterator operator++(int) {
+			Iterator result = *this;
+			++index_;
+			return result;
+		}
+		bool operator==(const Iterator& other) const {
+			return index_ == other.index_;
+		}
+		bool operator!=(const Iterator& other) const {
+			return index_ != other.index_;
+		}
+
+	private:
+		ranges::Range<const StopId*> stops_;
+		bool is_round_;
+		size_t index_;
+	};
+
+	RouteView(ranges::Range<const StopId*> stops, bool is_round)
+		: stops_(stops), is_round_(is_round) {
+	}
+	StopId operator[](size_t index) const {
+		return index < stops_.size() ? stops_[index] : stops_[2 * stops_.size() - 2 - index];
+	}
+	size_t size() const {
+		return is_round_ || stops_.empty() ? stops_.size() : 2 * stops_.size() - 1;
+	}
+	bool empty() const {
+		return stops_.empty();
+	}
+	Iterator begin() const {
+		return {stops_, is_round_, 0};
+	}
+	Iterator end() const {
+		return {stops_, is_round_, size()};
+	}
+
+private:
+	ranges::Range<const StopId*> stops_;
+	bool is_round_;
+};
+
 struct Bus {
-	std::string name;
-	std::vector<Stop*> stops;
+	std::string_view name;
+	// Для некольцевого маршрута хранится только путь в одну сторону
+	ranges::Range<const StopId*> stops;
 	bool is_round;
+
+	RouteView GetRoute() const {
+		return {stops, is_round};
+	}
 };
 
 } // transport_catalogue
\ No newline at end of file
@@ -1,19 +1,212 @@
 #define _USE_MATH_DEFINES
 #include "geo.h"
 
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define GEO_HAS_AVX2_KERNEL
+#endif
 
 namespace geo {
 
+namespace {
+
+const double dr = 3.1415926535 / 180.;
+const double EARTH_RADIUS = 6371000;
+
+// Коэффициенты ряда Тейлора синуса до x^21: на [-pi/2, pi/2] ошибка меньше 2e-18. Около диаметрально
+// противоположных точек ошибка синуса усиливается извлечением корня из 1 - sin^2, поэтому ряд длиннее
+constexpr double SIN_COEFFICIENTS[] = {
+    1.0 / 51090942171709440000.0,
+    -1.0 / 121645100408832000.0,
+    1.0 / 355687428096000.0,
+    -1.0 / 1307674368000.0,
+    1.0 / 6227020800.0,
+    -1.0 / 39916800.0,
+    1.0 / 362880.0,
+    -1.0 / 5040.0,
+    1.0 / 120.0,
+    -1.0 / 6.0,
+    1.0,
+};
+
+// Коэффициенты ряда арксинуса (2k)! / (4^k (k!)^2 (2k + 1)), k = 0..22, от старших к младшим:
+// на [0, 0.5] отброшенный остаток меньше 1e-16
+struct AsinCoefficients {
+    double values[23];
+
+    constexpr AsinCoefficients() : values() {
+        double binomial = 1.0;
+        for (int k = 0; k < 23; ++k) {
+            values[22 - k] = binomial / (2 * k + 1);
+            binomial = binomial * (2 * k + 1) / (2 * k + 2);
+        }
+    }
+};
+
+constexpr AsinCoefficients ASIN_COEFFICIENTS;
+
+// Синус угла из [-pi/2, pi/2]
+double SinPoly(double x) {
+    const double x2 = x * x;
+    double result = SIN_COEFFICIENTS[0];
+    for (size_t i = 1; i < std::size(SIN_COEFFICIENTS); ++i) {
+        result = result * x2 + SIN_COEFFICIENTS[i];
+    }
+    return result * x;
+}
+
+// Арксинус числа из [0, 0.5]
+double AsinPoly(double x) {
+    const double x2 = x * x;
+    double result = ASIN_COEFFICIENTS.values[0];
+    for (size_t i = 1; i < std::size(ASIN_COEFFICIENTS.values); ++i) {
+        result = result * x2 + ASIN_COEFFICIENTS.values[i];
+    }
+    return result * x;
+}
+
+// Угол между точками: sin^2(dlat / 2) + cos(lat1) cos(lat2) sin^2(dlng / 2) = sin^2(angle / 2)
+double ComputeDistanceApprox(const PreparedLatitude& from_lat, double from_lng, const PreparedLatitude& to_lat,
+                             double to_lng) {
+    const double half_dlat = std::abs(from_lat.lat_rad - to_lat.lat_rad) * 0.5;
+    double half_dlng = std::abs(from_lng - to_lng) * dr * 0.5;
+    // sin^2 симметричен относительно pi/2
+    half_dlng = std::min(half_dlng, M_PI - half_dlng);
+    const double sin_dlat = SinPoly(half_dlat);
+    const double sin_dlng = SinPoly(half_dlng);
+    const double h = std::clamp(sin_dlat * sin_dlat + from_lat.cos_lat * to_lat.cos_lat * sin_dlng * sin_dlng, 0.0, 1.0);
+    const double r = std::sqrt(h);
+    // asin(r) = pi/2 - 2 asin(sqrt((1 - r) / 2)) сводит аргумент к [0, 0.5]
+    const double half_angle = r <= 0.5 ? AsinPoly(r) : M_PI_2 - 2 * AsinPoly(std::sqrt((1 - r) * 0.5));
+    return 2 * half_angle * EARTH_RADIUS;
+}
+
+#ifdef GEO_HAS_AVX2_KERNEL
+
+// Маскированная форма с явным нулевым источником: обычная читает неинициализированный регистр
+__attribute__((target("avx2,fma")))
+__m256d Gather(const double* base, __m128i index) {
+    const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, index, all, sizeof(double));
+}
+
+__attribute__((target("avx2,fma")))
+__m256d SinPoly(__m256d x) {
+    const __m256d x2 = _mm256_mul_pd(x, x);
+    __m256d result = _mm256_set1_pd(SIN_COEFFICIENTS[0]);
+    for (size_t i = 1; i < std::size(SIN_COEFFICIENTS); ++i) {
+        result = _mm256_fmadd_pd(result, x2, _mm256_set1_pd(SIN_COEFFICIENTS[i]));
+    }
+    return _mm256_mul_pd(result, x);
+}
+
+__attribute__((target("avx2,fma")))
+__m256d AsinPoly(__m256d x) {
+    const __m256d x2 = _mm256_mul_pd(x, x);
+    __m256d result = _mm256_set1_pd(ASIN_COEFFICIENTS.values[0]);
+    for (size_t i = 1; i < std::size(ASIN_COEFFICIENTS.values); ++i) {
+        result = _mm256_fmadd_pd(result, x2, _mm256_set1_pd(ASIN_COEFFICIENTS.values[i]));
+    }
+    return _mm256_mul_pd(result, x);
+}
+
+// Та же формула, что в ComputeDistanceApprox; обе ветви арксинуса считаются и смешиваются.
+// Широты и долготы собираются по индексам gather-инструкциями со знаковыми 32-битными смещениями,
+// поэтому идентификаторы точек должны быть меньше 2^31 / 3
+__attribute__((target("avx2,fma")))
+size_t ComputeDistancesAvx2(const PreparedLatitude& from_lat, double from_lng, PreparedCoordinatesView points,
+                            const uint32_t* ids, size_t count, double* distances) {
+    constexpr int LATITUDE_STRIDE = sizeof(PreparedLatitude) / sizeof(double);
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d pi = _mm256_set1_pd(M_PI);
+    const __m256d half_pi = _mm256_set1_pd(M_PI_2);
+    const __m256d half_dr = _mm256_set1_pd(dr * 0.5);
+    const __m256d diameter = _mm256_set1_pd(2 * EARTH_RADIUS);
+    const __m256d from_lat_rad = _mm256_set1_pd(from_lat.lat_rad);
+    const __m256d from_lng_deg = _mm256_set1_pd(from_lng);
+    const __m256d from_cos_lat = _mm256_set1_pd(from_lat.cos_lat);
+    const double* lat_rads = &points.latitudes->lat_rad;
+    const double* cos_lats = &points.latitudes->cos_lat;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ids + i));
+        const __m128i latitude_index = _mm_mullo_epi32(index, _mm_set1_epi32(LATITUDE_STRIDE));
+        const __m256d lat_rad = Gather(lat_rads, latitude_index);
+        const __m256d cos_lat = Gather(cos_lats, latitude_index);
+        const __m256d lng = Gather(points.coordinates.lngs, index);
+
+        const __m256d half_dlat = _mm256_mul_pd(_mm256_andnot_pd(sign_mask, _mm256_sub_pd(from_lat_rad, lat_rad)), half);
+        __m256d half_dlng = _mm256_mul_pd(_mm256_andnot_pd(sign_mask, _mm256_sub_pd(from_lng_deg, lng)), half_dr);
+        half_dlng = _mm256_min_pd(half_dlng, _mm256_sub_pd(pi, half_dlng));
+        const __m256d sin_dlat = SinPoly(half_dlat);
+        const __m256d sin_dlng = SinPoly(half_dlng);
+        const __m256d cos_product = _mm256_mul_pd(from_cos_lat, cos_lat);
+        __m256d h = _mm256_fmadd_pd(_mm256_mul_pd(cos_product, sin_dlng), sin_dlng, _mm256_mul_pd(sin_dlat, sin_dlat));
+        h = _mm256_min_pd(_mm256_max_pd(h, _mm256_setzero_pd()), one);
+        const __m256d r = _mm256_sqrt_pd(h);
+        const __m256d near = AsinPoly(r);
+        const __m256d far = _mm256_fnmadd_pd(_mm256_set1_pd(2.0), AsinPoly(_mm256_sqrt_pd(_mm256_mul_pd(_mm256_sub_pd(one, r), half))), half_pi);
+        const __m256d half_angle = _mm256_blendv_pd(near, far, _mm256_cmp_pd(r, half, _CMP_GT_OQ));
+        _mm256_storeu_pd(distances + i, _mm256_mul_pd(half_angle, diameter));
+    }
+    return i;
+}
+
+bool HasAvx2() {
+    static const bool result = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return result;
+}
+
+#endif
+
+} // namespace
+
 double ComputeDistance(Coordinates from, Coordinates to) {
     using namespace std;
     if (from == to) {
         return 0;
     }
-    static const double dr = 3.1415926535 / 180.;
     return acos(sin(from.lat * dr) * sin(to.lat * dr)
                 + cos(from.lat * dr) * cos(to.lat * dr) * cos(abs(from.lng - to.lng) * dr))
-        * 6371000;
+        * EARTH_RADIUS;
+}
+
+PreparedLatitude PrepareLatitude(double lat) {
+    // Те же выражения, что в ComputeDistance, поэтому синус и косинус совпадают с ними точно
+    return {lat * dr, std::sin(lat * dr), std::cos(lat * dr)};
+}
+
+void ComputeDistances(PreparedCoordinatesView points, const uint32_t* path, size_t count, double* distances) {
+    using namespace std;
+    for (size_t i = 0; i < count; ++i) {
+        const Coordinates from = points.coordinates[path[i]];
+        const Coordinates to = points.coordinates[path[i + 1]];
+        const PreparedLatitude& from_lat = points.latitudes[path[i]];
+        const PreparedLatitude& to_lat = points.latitudes[path[i + 1]];
+        distances[i] = from == to ? 0
+            : acos(from_lat.sin_lat * to_lat.sin_lat + from_lat.cos_lat * to_lat.cos_lat * cos(abs(from.lng - to.lng) * dr))
+                * EARTH_RADIUS;
+    }
+}
+
+void ComputeDistancesApprox(Coordinates from, PreparedCoordinatesView points, const uint32_t* ids, size_t count,
+                            double* distances) {
+    const PreparedLatitude from_lat = PrepareLatitude(from.lat);
+    size_t i = 0;
+#ifdef GEO_HAS_AVX2_KERNEL
+    if (HasAvx2()) {
+        i = ComputeDistancesAvx2(from_lat, from.lng, points, ids, count, distances);
+    }
+#endif
+    for (; i < count; ++i) {
+        distances[i] = ComputeDistanceApprox(from_lat, from.lng, points.latitudes[ids[i]], points.coordinates.lngs[ids[i]]);
+    }
 }
 
 }  // namespace geo
\ No newline at end of file
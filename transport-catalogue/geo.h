@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 namespace geo {
 
 struct Coordinates {
@@ -13,6 +16,63 @@ struct Coordinates {
     }
 };
 
+// Прямоугольник в координатах широты и долготы, границы включаются
+struct BoundingBox {
+    Coordinates min;
+    Coordinates max;
+
+    bool Contains(Coordinates point) const {
+        return point.lat >= min.lat && point.lat <= max.lat && point.lng >= min.lng && point.lng <= max.lng;
+    }
+    bool Contains(const BoundingBox& other) const {
+        return Contains(other.min) && Contains(other.max);
+    }
+    bool Intersects(const BoundingBox& other) const {
+        return min.lat <= other.max.lat && other.min.lat <= max.lat
+            && min.lng <= other.max.lng && other.min.lng <= max.lng;
+    }
+};
+
+// Широты и долготы точек в отдельных плотных массивах: точка i — (lats[i], lngs[i])
+struct CoordinatesView {
+    const double* lats;
+    const double* lngs;
+    size_t size;
+
+    Coordinates operator[](size_t index) const {
+        return {lats[index], lngs[index]};
+    }
+};
+
+// Широта в радианах с её синусом и косинусом, вычисленными один раз
+struct PreparedLatitude {
+    double lat_rad;
+    double sin_lat;
+    double cos_lat;
+};
+
+// Координаты точек вместе с подготовленными широтами: latitudes[i] = PrepareLatitude(lats[i])
+struct PreparedCoordinatesView {
+    CoordinatesView coordinates;
+    const PreparedLatitude* latitudes;
+};
+
+// Верхняя граница отличия ComputeDistancesApprox от ComputeDistance в метрах
+constexpr double APPROX_DISTANCE_ERROR = 0.5;
+
 double ComputeDistance(Coordinates from, Coordinates to);
+PreparedLatitude PrepareLatitude(double lat);
+// Длины отрезков ломаной по точкам points[path[0]], points[path[1]], ..., points[path[count]]:
+// distances[i] — расстояние между points[path[i]] и points[path[i + 1]], бит в бит равное ComputeDistance.
+// Синус и косинус широт берутся из подготовленных, на отрезок остаются косинус разности долгот и арккосинус
+void ComputeDistances(PreparedCoordinatesView points, const uint32_t* path, size_t count, double* distances);
+// Приближённые расстояния distances[i] от from до points[ids[i]] по формуле гаверсинусов с полиномиальными
+// синусом и арксинусом, на процессорах с AVX2 и FMA — по четыре точки за раз. Отличие от ComputeDistance
+// не больше 1e-4 м на расстояниях от 100 м до 19 000 км. Ближе основную ошибку даёт сама ComputeDistance:
+// арккосинус плохо обусловлен около единицы, и на расстоянии d она ошибается примерно на 4e-3 м² / d,
+// но не больше 0.15 м. Около диаметрально противоположных точек плохо обусловлены обе формулы, отличие
+// доходит до 0.3 м. Результат годится для отсева точек с запасом APPROX_DISTANCE_ERROR, но не для печати
+void ComputeDistancesApprox(Coordinates from, PreparedCoordinatesView points, const uint32_t* ids, size_t count,
+                            double* distances);
 
 } // namespace geo
\ No newline at end of file
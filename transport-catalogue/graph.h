@@ -1,8 +1,11 @@
 #pragma once
 
+#include "memory_stats.h"
 #include "ranges.h"
 
 #include <cstdlib>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace graph {
@@ -26,12 +29,16 @@ private:
 public:
     DirectedWeightedGraph() = default;
     explicit DirectedWeightedGraph(size_t vertex_count);
+    // Граф с готовым массивом рёбер: идентификатор ребра — его индекс в edges
+    DirectedWeightedGraph(size_t vertex_count, std::vector<Edge<Weight>> edges);
     EdgeId AddEdge(const Edge<Weight>& edge);
+    void SetEdgeWeight(EdgeId edge_id, Weight weight);
 
     size_t GetVertexCount() const;
     size_t GetEdgeCount() const;
     const Edge<Weight>& GetEdge(EdgeId edge_id) const;
     IncidentEdgesRange GetIncidentEdges(VertexId vertex) const;
+    memory_stats::MemoryStats GetMemoryStats() const;
 
 private:
     std::vector<Edge<Weight>> edges_;
@@ -43,6 +50,26 @@ DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count)
     : incidence_lists_(vertex_count) {
 }
 
+template <typename Weight>
+DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count, std::vector<Edge<Weight>> edges)
+    : edges_(std::move(edges))
+    , incidence_lists_(vertex_count) {
+    // Списки сразу получают точный размер, без перевыделений при добавлении
+    std::vector<size_t> degrees(vertex_count, 0);
+    for (const Edge<Weight>& edge : edges_) {
+        ++degrees.at(edge.from);
+        if (edge.to >= vertex_count) {
+            throw std::out_of_range("Edge's vertex is out of range");
+        }
+    }
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        incidence_lists_[vertex].reserve(degrees[vertex]);
+    }
+    for (EdgeId id = 0; id < edges_.size(); ++id) {
+        incidence_lists_[edges_[id].from].push_back(id);
+    }
+}
+
 template <typename Weight>
 EdgeId DirectedWeightedGraph<Weight>::AddEdge(const Edge<Weight>& edge) {
     edges_.push_back(edge);
@@ -51,6 +78,11 @@ EdgeId DirectedWeightedGraph<Weight>::AddEdge(const Edge<Weight>& edge) {
     return id;
 }
 
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::SetEdgeWeight(EdgeId edge_id, Weight weight) {
+    edges_.at(edge_id).weight = weight;
+}
+
 template <typename Weight>
 size_t DirectedWeightedGraph<Weight>::GetVertexCount() const {
     return incidence_lists_.size();
@@ -71,4 +103,16 @@ typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
 DirectedWeightedGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
     return ranges::AsRange(incidence_lists_.at(vertex));
 }
+
+template <typename Weight>
+memory_stats::MemoryStats DirectedWeightedGraph<Weight>::GetMemoryStats() const {
+    memory_stats::MemoryStats stats;
+    stats.Add("edges", memory_stats::GetVectorUsage(edges_));
+    memory_stats::Usage incidence_lists = memory_stats::GetVectorUsage(incidence_lists_);
+    for (const IncidenceList& list : incidence_lists_) {
+        incidence_lists.bytes += memory_stats::GetVectorUsage(list).bytes;
+    }
+    stats.Add("incidence_lists", incidence_lists);
+    return stats;
+}
 }  // namespace graph
\ No newline at end of file
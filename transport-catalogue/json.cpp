@@ -1,326 +1,435 @@
 #include "json.h"
 
-#include <iterator>
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
 #include <stdexcept>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace json {
 
 using namespace std::literals;
 
 namespace detail {
 
-Node LoadNode(std::istream& input);
-Node LoadString(std::istream& input);
+// Пробельные символы в смысле std::isspace для локали "C"
+bool IsSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
 
-std::string LoadLiteral(std::istream& input) {
-    std::string result;
-    while (std::isalpha(input.peek())) {
-        result.push_back(static_cast<char>(input.get()));
-    }
-    return result;
+bool IsDigit(int c) {
+    return c >= '0' && c <= '9';
 }
 
-Node LoadNull(std::istream& input) {
-    std::string str = LoadLiteral(input);
-    if (str == "null"s) {
-        return Node(nullptr);
-    } else {
-        throw ParsingError("Null parsing error: "s + str + " is not null"s);
-    }
+bool IsAlpha(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
 }
 
-Node LoadArray(std::istream& input) {
-    Array result;
+// Разбор из непрерывного буфера с передачей событий обработчику. Грамматика и сообщения
+// об ошибках те же, что у прежнего посимвольного разбора из потока: запятые между элементами
+// необязательны, всё после корневого значения игнорируется
+template <typename Handler>
+class Parser {
+public:
+    Parser(std::string_view input, Handler& handler)
+        : input_(input), handler_(handler) {
+    }
 
-    char c;
-    for (; input >> c && c != ']';) {
-        if (c != ',') {
-            input.putback(c);
+    void ParseNode() {
+        char c;
+        if (!ReadChar(c)) {
+            throw ParsingError("Load node error: Unexpected end of input"s);
         }
-        result.push_back(LoadNode(input));
-    }
 
-    if (c != ']') {
-        throw ParsingError("Array parsing error: There is no closing character ']'"s);
+        if (c == '[') {
+            ParseArray();
+        } else if (c == '{') {
+            ParseDict();
+        } else if (c == '"') {
+            handler_.String(LoadString());
+        } else if (c == 'n') {
+            --pos_;
+            ParseNull();
+        } else if (c == 't' || c == 'f') {
+            --pos_;
+            ParseBool();
+        } else if (IsDigit(c) || c == '-') {
+            --pos_;
+            ParseNumber();
+        } else {
+            throw ParsingError("Load node error: Unrecognized data type starting with "s + c);
+        }
     }
 
-    return Node(std::move(result));
-}
+private:
+    static constexpr size_t BLOCK_SIZE = 16;
 
-Node LoadDict(std::istream& input) {
-    Dict result;
+    std::string_view input_;
+    size_t pos_ = 0;
+    Handler& handler_;
+    // Строки с escape-последовательностями собираются здесь; без них передаются прямо из буфера
+    std::string unescaped_;
 
-    char c;
-    for (; input >> c && c != '}';) {
-        if (c == '"') {
-            std::string key = LoadString(input).AsString();
-            if (input >> c && c == ':') {
-                if (result.find(key) != result.end()) {
-                    throw ParsingError("Dict parsing error: Duplicate key '"s + key + "' have been found"s);
-                }
-                result.emplace(std::move(key), LoadNode(input));
-            } else {
-                throw ParsingError("Dict parsing error: ':' is expected but '"s + c + "' has been found"s);
+    // Аналог input >> c: пропускает пробельные символы и читает следующий
+    bool ReadChar(char& c) {
+        SkipSpaces();
+        if (pos_ == input_.size()) {
+            return false;
+        }
+        c = input_[pos_++];
+        return true;
+    }
+
+    int Peek() const {
+        return pos_ < input_.size() ? static_cast<unsigned char>(input_[pos_]) : EOF;
+    }
+
+    void SkipSpaces() {
+#ifdef __SSE2__
+        // Отступы отформатированного ввода пропускаются блоками по 16 байт
+        while (pos_ + BLOCK_SIZE <= input_.size()) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input_.data() + pos_));
+            // Коды \t, \n, \v, \f и \r идут подряд с 9 по 13
+            const __m128i shifted = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+            const __m128i controls = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8('\r' - '\t')), shifted);
+            const __m128i spaces = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')), controls);
+            const unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(spaces)) & 0xFFFF;
+            if (mask != 0) {
+                pos_ += __builtin_ctz(mask);
+                return;
             }
-        } else if (c != ',') {
-            throw ParsingError("Dict parsing error: ',' is expected but '"s + c + "' has been found"s);
+            pos_ += BLOCK_SIZE;
+        }
+#endif
+        while (pos_ < input_.size() && IsSpace(input_[pos_])) {
+            ++pos_;
         }
     }
 
-    if (c != '}') {
-        throw ParsingError("Dict parsing error: There is no closing character '}'"s);
+    // Позиция первого из символов '"', '\\', '\n', '\r' начиная с pos_ или конец буфера
+    size_t FindStringSpecial() const {
+        size_t pos = pos_;
+#ifdef __SSE2__
+        while (pos + BLOCK_SIZE <= input_.size()) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input_.data() + pos));
+            const __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('"')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\\'))),
+                _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\r'))));
+            if (const unsigned mask = _mm_movemask_epi8(special); mask != 0) {
+                return pos + __builtin_ctz(mask);
+            }
+            pos += BLOCK_SIZE;
+        }
+#endif
+        while (pos < input_.size() && input_[pos] != '"' && input_[pos] != '\\' && input_[pos] != '\n' && input_[pos] != '\r') {
+            ++pos;
+        }
+        return pos;
     }
 
-    return Node(std::move(result));
-}
+    std::string_view LoadLiteral() {
+        const size_t begin = pos_;
+        while (pos_ < input_.size() && IsAlpha(input_[pos_])) {
+            ++pos_;
+        }
+        return input_.substr(begin, pos_ - begin);
+    }
 
-Node LoadBool(std::istream& input) {
-    std::string str = LoadLiteral(input);
-    if (str == "true"s) {
-        return Node{true};
-    } else if (str == "false"s) {
-        return Node{false};
-    } else {
-        throw ParsingError("Bool parsing error: "s + str + " is not bool"s);
+    void ParseNull() {
+        std::string_view str = LoadLiteral();
+        if (str == "null"sv) {
+            handler_.Null();
+        } else {
+            throw ParsingError("Null parsing error: "s + std::string(str) + " is not null"s);
+        }
     }
-}
 
-Node LoadNumber(std::istream& input) {
-    std::string num_str;
-    auto read_char = [&num_str, &input]() {
-        num_str += static_cast<char>(input.get());
-        if (!input) {
-            throw ParsingError("Number parsing error: Failed to read from the stream"s);
+    void ParseArray() {
+        handler_.StartArray();
+
+        char c = '[';
+        bool has_char;
+        while ((has_char = ReadChar(c)) && c != ']') {
+            if (c != ',') {
+                --pos_;
+            }
+            ParseNode();
+        }
+
+        if (!has_char) {
+            throw ParsingError("Array parsing error: There is no closing character ']'"s);
         }
-    };
 
-    auto read_digits = [&input, read_char](){
-        if (!std::isdigit(input.peek())) {
-            throw ParsingError("Number parsing error: A digit is expected"s);
+        handler_.EndArray();
+    }
+
+    void ParseDict() {
+        handler_.StartDict();
+
+        char c = '{';
+        bool has_char;
+        while ((has_char = ReadChar(c)) && c != '}') {
+            if (c == '"') {
+                std::string_view key = LoadString();
+                if (ReadChar(c) && c == ':') {
+                    handler_.Key(key);
+                    ParseNode();
+                } else {
+                    throw ParsingError("Dict parsing error: ':' is expected but '"s + c + "' has been found"s);
+                }
+            } else if (c != ',') {
+                throw ParsingError("Dict parsing error: ',' is expected but '"s + c + "' has been found"s);
+            }
         }
-        while (std::isdigit(input.peek())) {
-            read_char();
+
+        if (!has_char) {
+            throw ParsingError("Dict parsing error: There is no closing character '}'"s);
         }
-    };
 
-    if (input.peek() == '-') {
-        read_char();
+        handler_.EndDict();
     }
-    read_digits();
 
-    bool is_int = true;
-    if (input.peek() == '.') {
-        read_char();
-        read_digits();
-        is_int = false;
+    void ParseBool() {
+        std::string_view str = LoadLiteral();
+        if (str == "true"sv) {
+            handler_.Bool(true);
+        } else if (str == "false"sv) {
+            handler_.Bool(false);
+        } else {
+            throw ParsingError("Bool parsing error: "s + std::string(str) + " is not bool"s);
+        }
     }
 
-    if (char ch = input.peek(); ch == 'e' || ch == 'E') {
-        read_char();
-        if (ch = input.peek(); ch == '+' || ch == '-') {
-            read_char();
+    void ParseNumber() {
+        const size_t begin = pos_;
+        auto read_digits = [this]() {
+            if (!IsDigit(Peek())) {
+                throw ParsingError("Number parsing error: A digit is expected"s);
+            }
+            while (IsDigit(Peek())) {
+                ++pos_;
+            }
+        };
+
+        if (Peek() == '-') {
+            ++pos_;
         }
         read_digits();
-        is_int = false;
-    }
 
-    try {
+        bool is_int = true;
+        if (Peek() == '.') {
+            ++pos_;
+            read_digits();
+            is_int = false;
+        }
+
+        if (int ch = Peek(); ch == 'e' || ch == 'E') {
+            ++pos_;
+            if (ch = Peek(); ch == '+' || ch == '-') {
+                ++pos_;
+            }
+            read_digits();
+            is_int = false;
+        }
+
+        // Запись числа уже проверена, from_chars разбирает её без копирования;
+        // при переполнении int, как и раньше, получается число с плавающей точкой
+        const char* first = input_.data() + begin;
+        const char* last = input_.data() + pos_;
         if (is_int) {
-            try {
-                return Node{std::stoi(num_str)};
-            } catch (...) {
-                // В случае неудачи, например, при переполнении
-                // код ниже попробует преобразовать строку в double
+            int value;
+            if (auto [ptr, error] = std::from_chars(first, last, value); error == std::errc{} && ptr == last) {
+                handler_.Int(value);
+                return;
             }
         }
-        return Node{std::stod(num_str)};
-    } catch (...) {
-        throw ParsingError("Number parsing error: Failed to convert "s + num_str + " to number"s);
+        double value;
+        if (auto [ptr, error] = std::from_chars(first, last, value); error == std::errc{} && ptr == last) {
+            handler_.Double(value);
+            return;
+        }
+        throw ParsingError("Number parsing error: Failed to convert "s + std::string(first, last) + " to number"s);
     }
-}
 
-Node LoadString(std::istream& input) {
-    auto it = std::istreambuf_iterator<char>(input);
-    auto end = std::istreambuf_iterator<char>();
-    std::string str;
-
-    while(true) {
-        if (it == end) {
-            throw ParsingError("String parsing error: There is no closing character \"");
+    // Строка до закрывающей кавычки; результат действителен до следующего вызова
+    std::string_view LoadString() {
+        const size_t begin = pos_;
+        pos_ = FindStringSpecial();
+        if (pos_ < input_.size() && input_[pos_] == '"') {
+            const std::string_view str = input_.substr(begin, pos_ - begin);
+            ++pos_;
+            return str;
         }
-        const char ch = *it;
-        if (ch == '"') {
-            ++it;
-            break;
-        } else if (ch == '\\') {
-            ++it;
-            if (it == end) {
-                throw ParsingError("String parsing error: The reading of the escape-sequence is interrupted");
+
+        std::string& str = unescaped_;
+        str.assign(input_.data() + begin, pos_ - begin);
+        while (true) {
+            // Участок без специальных символов копируется целиком
+            const size_t special = FindStringSpecial();
+            str.append(input_.data() + pos_, special - pos_);
+            pos_ = special;
+            if (pos_ == input_.size()) {
+                throw ParsingError("String parsing error: There is no closing character \"");
             }
-            const char escape_ch = *it;
-            switch (escape_ch) {
-                case 'n':
-                    str.push_back('\n');
-                    break;
-                case 't':
-                    str.push_back('\t');
-                    break;
-                case 'r':
-                    str.push_back('\r');
-                    break;
-                case '"':
-                    str.push_back('\"');
-                    break;
-                case '\\':
-                    str.push_back('\\');
-                    break;
-                default:
-                    throw ParsingError("String parsing error: Unrecognized escape-sequence \\"s + escape_ch);
+            const char ch = input_[pos_];
+            if (ch == '"') {
+                ++pos_;
+                break;
+            } else if (ch == '\\') {
+                ++pos_;
+                if (pos_ == input_.size()) {
+                    throw ParsingError("String parsing error: The reading of the escape-sequence is interrupted");
+                }
+                const char escape_ch = input_[pos_];
+                switch (escape_ch) {
+                    case 'n':
+                        str.push_back('\n');
+                        break;
+                    case 't':
+                        str.push_back('\t');
+                        break;
+                    case 'r':
+                        str.push_back('\r');
+                        break;
+                    case '"':
+                        str.push_back('\"');
+                        break;
+                    case '\\':
+                        str.push_back('\\');
+                        break;
+                    default:
+                        throw ParsingError("String parsing error: Unrecognized escape-sequence \\"s + escape_ch);
+                }
+                ++pos_;
+            } else {
+                throw ParsingError("String parsing error: Unexpected end of line");
             }
-        } else if (ch == '\n' || ch == '\r') {
-            throw ParsingError("String parsing error: Unexpected end of line");
-        } else {
-            str.push_back(ch);
         }
-        ++it;
-    }   
-
-    return Node(std::move(str));
-}
-
-Node LoadNode(std::istream& input) {
-    char c;
-    input >> c;
-
-    if (c == '[') {
-        return LoadArray(input);
-    } else if (c == '{') {
-        return LoadDict(input);
-    } else if (c == '"') {
-        return LoadString(input);
-    } else if (c == 'n') {
-        input.putback(c);
-        return LoadNull(input);
-    } else if (c == 't' || c == 'f') {
-        input.putback(c);
-        return LoadBool(input);
-    } else if (std::isdigit(c) || c == '-') {
-        input.putback(c);
-        return LoadNumber(input);
-    } else {
-        throw ParsingError("Load node error: Unrecognized data type starting with "s + c);
+
+        return str;
     }
+};
+
+// Обработчик, вызовы которого Parser может встроить без виртуальной диспетчеризации
+class DocumentBuilder final : public TreeBuilder {
+public:
+    using TreeBuilder::TreeBuilder;
+};
+
+// Пробелы отступа пишутся кусками этой строки
+constexpr std::string_view INDENT_SPACES = "                                "sv;
+
+}  // namespace detail
+
+DictKey::DictKey(std::string key)
+    : value_(std::move(key)) {
 }
 
-struct PrintContext {
-    std::ostream& out;
-    int indent_step = 4;
-    int indent = 0;
+DictKey::DictKey(Value value)
+    : value_(std::move(value)) {
+}
 
-    void PrintIndent() const {
-        for (int i = 0; i < indent; ++i) {
-            out.put(' ');
-        }
-    }
+DictKey DictKey::View(std::string_view key) {
+    return DictKey(Value(key));
+}
 
-    PrintContext Indented() const {
-        return {out, indent_step, indent + indent_step};
+DictKey::operator std::string_view() const {
+    if (const auto* key = std::get_if<std::string_view>(&value_)) {
+        return *key;
     }
-};
+    return std::get<std::string>(value_);
+}
 
-void PrintNode(const Node& node, const PrintContext& context);
-
-std::string SetEscapeSequences(const std::string& str) {
-    std::string result;
-    for (const char c : str) {
-        if (c == '\n') {
-            result += "\\n"s;
-        } else if (c == '\t') {
-            result += "\\t"s;
-        } else if (c == '\r') {
-            result += "\\r"s;
-        } else if (c == '\"') {
-            result += "\\\""s;
-        } else if (c == '\\') {
-            result += "\\\\"s;
-        } else {
-            result += c;
-        }
-    }
-    return result;
+const DictKey::Value& DictKey::GetValue() const {
+    return value_;
 }
 
-void PrintValue(std::nullptr_t, const PrintContext& context) {
-    context.out << "null"s;
+bool operator==(const DictKey& lhs, const DictKey& rhs) {
+    return std::string_view(lhs) == std::string_view(rhs);
 }
 
-void PrintValue(const Array& value, const PrintContext& context) {
-    if (value.size() > 0) {
-        bool is_first = true;
-        context.out << "["s << std::endl;
-        PrintContext indented_context{context.Indented()};
-        indented_context.PrintIndent();
-        for (const auto& elem : value) {
-            if (!is_first) {
-                context.out << ", "s << std::endl;
-                indented_context.PrintIndent();
-            }
-            PrintNode(elem, indented_context);
-            is_first = false;
-        }
-        context.out << std::endl;
-        context.PrintIndent();
-        context.out << "]"s;
-    } else {
-        context.out << "[]"s;
-    }
+bool operator!=(const DictKey& lhs, const DictKey& rhs) {
+    return !(lhs == rhs);
 }
 
-void PrintValue(const Dict& value, const PrintContext& context) {
-    if (value.size() > 0) {
-        bool is_first = true;
-        context.out << "{"s << std::endl;
-        PrintContext indented_context{context.Indented()};
-        indented_context.PrintIndent();
-        for (const auto& elem : value) {
-            if (!is_first) {
-                context.out << ", "s << std::endl;
-                indented_context.PrintIndent();
-            }
-            PrintNode(elem.first, indented_context);
-            context.out << ": "s;
-            PrintNode(elem.second, indented_context);
-            is_first = false;
-        }
-        context.out << std::endl;
-        context.PrintIndent();
-        context.out << "}"s;
-    } else {
-        context.out << "{}"s;
+bool operator<(const DictKey& lhs, const DictKey& rhs) {
+    return std::string_view(lhs) < std::string_view(rhs);
+}
+
+std::ostream& operator<<(std::ostream& output, const DictKey& key) {
+    return output << std::string_view(key);
+}
+
+Dict::const_iterator Dict::begin() const {
+    return items_.begin();
+}
+
+Dict::const_iterator Dict::end() const {
+    return items_.end();
+}
+
+size_t Dict::size() const {
+    return items_.size();
+}
+
+bool Dict::empty() const {
+    return items_.empty();
+}
+
+size_t Dict::capacity() const {
+    return items_.capacity();
+}
+
+Dict::const_iterator Dict::find(std::string_view key) const {
+    if (items_.size() <= LINEAR_SEARCH_SIZE) {
+        return std::find_if(items_.begin(), items_.end(), [key](const value_type& item) {
+            return item.first == key;
+        });
     }
+    const auto it = lower_bound(key);
+    return it != items_.end() && it->first == key ? it : items_.end();
 }
 
-void PrintValue(bool value, const PrintContext& context) {
-    context.out << std::boolalpha << value;
+const Node& Dict::at(std::string_view key) const {
+    const auto it = find(key);
+    if (it == items_.end()) {
+        throw std::out_of_range("Dict key "s + std::string(key) + " is not found"s);
+    }
+    return it->second;
 }
 
-void PrintValue(int value, const PrintContext& context) {
-    context.out << value;
+Dict::const_iterator Dict::lower_bound(std::string_view key) const {
+    // Ключи обычно приходят по возрастанию, и новый ключ оказывается в конце
+    if (items_.empty() || items_.back().first < key) {
+        return items_.end();
+    }
+    return std::lower_bound(items_.begin(), items_.end(), key, [](const value_type& item, std::string_view key) {
+        return item.first < key;
+    });
 }
 
-void PrintValue(double value, const PrintContext& context) {
-    context.out << value;
+Node& Dict::operator[](std::string_view key) {
+    auto it = lower_bound(key);
+    if (it == items_.end() || it->first != key) {
+        it = items_.emplace(it, std::string(key), nullptr);
+    }
+    return items_[it - items_.begin()].second;
 }
 
-void PrintValue(const std::string& value, const PrintContext& context) {
-    context.out << "\""s << SetEscapeSequences(value) << "\""s;
+void Dict::emplace_hint(const_iterator position, DictKey key, Node value) {
+    items_.emplace(position, std::move(key), std::move(value));
 }
 
-void PrintNode(const Node& node, const PrintContext& context) {
-    std::visit([&context](const auto& value) {PrintValue(value, context);}, node.GetValue());
+bool operator==(const Dict& lhs, const Dict& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-}  // namespace detail
+bool operator!=(const Dict& lhs, const Dict& rhs) {
+    return !(lhs == rhs);
+}
 
 bool Node::IsInt() const {
     return std::holds_alternative<int>(*this);
@@ -339,7 +448,7 @@ bool Node::IsBool() const {
 }
 
 bool Node::IsString() const {
-    return std::holds_alternative<std::string>(*this);
+    return std::holds_alternative<std::string>(*this) || std::holds_alternative<std::string_view>(*this);
 }
 
 bool Node::IsNull() const {
@@ -380,7 +489,10 @@ double Node::AsDouble() const {
     }
 }
 
-const std::string& Node::AsString() const {
+std::string_view Node::AsString() const {
+    if (const auto* value = std::get_if<std::string_view>(this)) {
+        return *value;
+    }
     if (!IsString()) {
         throw std::logic_error("Is not string!"s);
     }
@@ -409,6 +521,10 @@ const Node::Value& Node::GetValue() const {
 }
 
 bool operator==(const Node& lhs, const Node& rhs) {
+    // Своя строка и ссылка на строку равны, если совпадает текст
+    if (lhs.IsString() && rhs.IsString()) {
+        return lhs.AsString() == rhs.AsString();
+    }
     return lhs.GetValue() == rhs.GetValue();
 }
 
@@ -432,12 +548,324 @@ bool operator!=(const Document& lhs, const Document& rhs) {
     return !(lhs == rhs);
 }
 
+TreeBuilder::TreeBuilder(std::string_view input, StringStorage& storage)
+    : input_(input), storage_(&storage) {
+}
+
+void TreeBuilder::StartArray() {
+    frames_.push_back({});
+}
+
+void TreeBuilder::EndArray() {
+    Node value(std::move(frames_.back().array));
+    frames_.pop_back();
+    AddValue(std::move(value));
+}
+
+void TreeBuilder::StartDict() {
+    frames_.push_back({});
+    frames_.back().is_dict = true;
+}
+
+void TreeBuilder::Key(std::string_view key) {
+    Frame& frame = frames_.back();
+    frame.position = frame.dict.lower_bound(key);
+    if (frame.position != frame.dict.end() && frame.position->first == key) {
+        throw ParsingError("Dict parsing error: Duplicate key '"s + std::string(key) + "' have been found"s);
+    }
+    frame.key = storage_ == nullptr ? DictKey(std::string(key)) : DictKey::View(Keep(key));
+}
+
+void TreeBuilder::EndDict() {
+    Node value(std::move(frames_.back().dict));
+    frames_.pop_back();
+    AddValue(std::move(value));
+}
+
+void TreeBuilder::Null() {
+    AddValue(nullptr);
+}
+
+void TreeBuilder::Bool(bool value) {
+    AddValue(value);
+}
+
+void TreeBuilder::Int(int value) {
+    AddValue(value);
+}
+
+void TreeBuilder::Double(double value) {
+    AddValue(value);
+}
+
+void TreeBuilder::String(std::string_view value) {
+    if (storage_ == nullptr) {
+        AddValue(std::string(value));
+    } else {
+        AddValue(Keep(value));
+    }
+}
+
+bool TreeBuilder::IsComplete() const {
+    return frames_.empty();
+}
+
+Node TreeBuilder::Build() {
+    return std::move(root_);
+}
+
+std::string_view TreeBuilder::Keep(std::string_view value) {
+    if (value.data() >= input_.data() && value.data() + value.size() <= input_.data() + input_.size()) {
+        return value;
+    }
+    return storage_->emplace_back(value);
+}
+
+void TreeBuilder::AddValue(Node value) {
+    if (frames_.empty()) {
+        root_ = std::move(value);
+        return;
+    }
+    Frame& frame = frames_.back();
+    if (frame.is_dict) {
+        frame.dict.emplace_hint(frame.position, std::move(frame.key), std::move(value));
+    } else {
+        frame.array.push_back(std::move(value));
+    }
+}
+
+std::string ReadAll(std::istream& input) {
+    std::string buffer;
+    char chunk[1 << 16];
+    while (input.read(chunk, sizeof(chunk)) || input.gcount() > 0) {
+        buffer.append(chunk, static_cast<size_t>(input.gcount()));
+    }
+    return buffer;
+}
+
+void Parse(std::string_view input, Handler& handler) {
+    detail::Parser<Handler>(input, handler).ParseNode();
+}
+
 Document Load(std::istream& input) {
-    return Document{detail::LoadNode(input)};
+    return Load(ReadAll(input));
+}
+
+Document Load(std::string_view input) {
+    detail::DocumentBuilder builder;
+    detail::Parser<detail::DocumentBuilder>(input, builder).ParseNode();
+    return Document(builder.Build());
+}
+
+Document Load(std::string_view input, StringStorage& storage) {
+    detail::DocumentBuilder builder(input, storage);
+    detail::Parser<detail::DocumentBuilder>(input, builder).ParseNode();
+    return Document(builder.Build());
+}
+
+Writer::Writer(std::ostream& output)
+    : output_(output) {
+    buffer_.reserve(BUFFER_SIZE);
+}
+
+Writer::~Writer() {
+    Flush();
+}
+
+Writer& Writer::StartArray() {
+    BeginValue();
+    buffer_ += '[';
+    has_items_.push_back(false);
+    return *this;
+}
+
+Writer& Writer::EndArray() {
+    EndContainer(']');
+    return *this;
+}
+
+Writer& Writer::StartDict() {
+    BeginValue();
+    buffer_ += '{';
+    has_items_.push_back(false);
+    return *this;
+}
+
+Writer& Writer::Key(std::string_view key) {
+    BeginValue();
+    WriteString(key);
+    buffer_ += ": "sv;
+    is_after_key_ = true;
+    return *this;
+}
+
+Writer& Writer::EndDict() {
+    EndContainer('}');
+    return *this;
+}
+
+Writer& Writer::Value(std::nullptr_t) {
+    BeginValue();
+    buffer_ += "null"sv;
+    return *this;
+}
+
+Writer& Writer::Value(bool value) {
+    BeginValue();
+    buffer_ += value ? "true"sv : "false"sv;
+    return *this;
+}
+
+Writer& Writer::Value(int value) {
+    BeginValue();
+    char chars[16];
+    const auto result = std::to_chars(std::begin(chars), std::end(chars), value);
+    buffer_.append(chars, result.ptr);
+    return *this;
+}
+
+Writer& Writer::Value(double value) {
+    BeginValue();
+    // Как вывод в поток с настройками по умолчанию: %g с точностью 6
+    char chars[32];
+    const auto result = std::to_chars(std::begin(chars), std::end(chars), value, std::chars_format::general, 6);
+    buffer_.append(chars, result.ptr);
+    return *this;
+}
+
+Writer& Writer::Value(std::string_view value) {
+    BeginValue();
+    WriteString(value);
+    return *this;
+}
+
+Writer& Writer::Value(const char* value) {
+    return Value(std::string_view(value));
+}
+
+Writer& Writer::WriteNode(const Node& node) {
+    if (node.IsArray()) {
+        StartArray();
+        for (const Node& item : node.AsArray()) {
+            WriteNode(item);
+        }
+        EndArray();
+    } else if (node.IsMap()) {
+        StartDict();
+        for (const auto& [key, value] : node.AsMap()) {
+            Key(key);
+            WriteNode(value);
+        }
+        EndDict();
+    } else {
+        std::visit([this](const auto& value) {
+            using T = std::decay_t<decltype(value)>;
+            if constexpr (!std::is_same_v<T, Array> && !std::is_same_v<T, Dict>) {
+                Value(value);
+            }
+        }, node.GetValue());
+    }
+    return *this;
+}
+
+void Writer::Flush() {
+    output_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+}
+
+void Writer::BeginValue() {
+    if (is_after_key_) {
+        is_after_key_ = false;
+        return;
+    }
+    if (has_items_.empty()) {
+        return;
+    }
+    if (buffer_.size() >= BUFFER_SIZE) {
+        Flush();
+    }
+    buffer_ += has_items_.back() ? ", \n"sv : "\n"sv;
+    has_items_.back() = true;
+    WriteIndent(has_items_.size());
+}
+
+void Writer::EndContainer(char bracket) {
+    const bool has_items = has_items_.back();
+    has_items_.pop_back();
+    if (has_items) {
+        buffer_ += '\n';
+        WriteIndent(has_items_.size());
+    }
+    buffer_ += bracket;
+}
+
+void Writer::WriteIndent(size_t depth) {
+    for (size_t count = depth * INDENT_STEP; count > 0;) {
+        const size_t part = std::min(count, detail::INDENT_SPACES.size());
+        buffer_ += detail::INDENT_SPACES.substr(0, part);
+        count -= part;
+    }
+}
+
+void Writer::WriteString(std::string_view value) {
+    buffer_ += '"';
+    for (const char c : value) {
+        switch (c) {
+            case '\n':
+                buffer_ += "\\n"sv;
+                break;
+            case '\t':
+                buffer_ += "\\t"sv;
+                break;
+            case '\r':
+                buffer_ += "\\r"sv;
+                break;
+            case '"':
+                buffer_ += "\\\""sv;
+                break;
+            case '\\':
+                buffer_ += "\\\\"sv;
+                break;
+            default:
+                buffer_ += c;
+        }
+    }
+    buffer_ += '"';
 }
 
 void Print(const Document& doc, std::ostream& output) {
-    detail::PrintNode(doc.GetRoot(), detail::PrintContext{output});
+    Writer(output).WriteNode(doc.GetRoot());
+}
+
+memory_stats::Usage GetMemoryUsage(const Node& node) {
+    memory_stats::Usage result{1, 0};
+    if (node.IsArray()) {
+        const Array& array = node.AsArray();
+        result.bytes += memory_stats::GetVectorUsage(array).bytes;
+        for (const Node& item : array) {
+            result += GetMemoryUsage(item);
+        }
+    } else if (node.IsMap()) {
+        const Dict& dict = node.AsMap();
+        result.bytes += memory_stats::GetAllocationSize(dict.capacity() * sizeof(Dict::value_type));
+        for (const auto& [key, value] : dict) {
+            if (const auto* str = std::get_if<std::string>(&key.GetValue())) {
+                result.bytes += memory_stats::GetStringUsage(*str).bytes;
+            }
+            result += GetMemoryUsage(value);
+        }
+    } else if (const auto* str = std::get_if<std::string>(&node.GetValue())) {
+        result.bytes += memory_stats::GetStringUsage(*str).bytes;
+    }
+    return result;
+}
+
+memory_stats::Usage GetMemoryUsage(const StringStorage& storage) {
+    memory_stats::Usage result{storage.size(), 0};
+    for (const std::string& str : storage) {
+        result.bytes += memory_stats::GetStringUsage(str).bytes;
+    }
+    return result;
 }
 
 }  // namespace json
\ No newline at end of file
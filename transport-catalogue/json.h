@@ -1,23 +1,86 @@
 #pragma once
 
+#include <deque>
 #include <iostream>
-#include <map>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
+#include "memory_stats.h"
+
 namespace json {
 
 class Node;
-using Dict = std::map<std::string, Node>;
 using Array = std::vector<Node>;
 
+// Ключ словаря хранится, как строка узла: своей строкой или ссылкой на буфер, который живёт
+// дольше словаря. Сравнивается и преобразуется в std::string_view без копирования
+class DictKey {
+public:
+    using Value = std::variant<std::string, std::string_view>;
+
+    DictKey(std::string key);
+    // Ключ-ссылка: строка не копируется
+    static DictKey View(std::string_view key);
+
+    operator std::string_view() const;
+    const Value& GetValue() const;
+
+private:
+    Value value_;
+
+    explicit DictKey(Value value);
+};
+
+bool operator==(const DictKey& lhs, const DictKey& rhs);
+bool operator!=(const DictKey& lhs, const DictKey& rhs);
+bool operator<(const DictKey& lhs, const DictKey& rhs);
+std::ostream& operator<<(std::ostream& output, const DictKey& key);
+
+// Словарь — вектор пар, упорядоченный по ключу: обходится в том же порядке, что std::map,
+// не выделяет память под каждый элемент, а поиск по std::string_view не создаёт временных строк.
+// Небольшие словари просматриваются подряд, большие — двоичным поиском
+class Dict {
+public:
+    using value_type = std::pair<DictKey, Node>;
+    using const_iterator = std::vector<value_type>::const_iterator;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    size_t size() const;
+    bool empty() const;
+    size_t capacity() const;
+
+    const_iterator find(std::string_view key) const;
+    // Выбрасывает std::out_of_range, если ключа нет
+    const Node& at(std::string_view key) const;
+    // Первый элемент с ключом не меньше key
+    const_iterator lower_bound(std::string_view key) const;
+    // Значение по ключу; отсутствующий ключ добавляется со значением null
+    Node& operator[](std::string_view key);
+    // Вставляет элемент перед position; вставка не должна нарушать порядок ключей
+    void emplace_hint(const_iterator position, DictKey key, Node value);
+
+private:
+    static constexpr size_t LINEAR_SEARCH_SIZE = 8;
+
+    std::vector<value_type> items_;
+};
+
+bool operator==(const Dict& lhs, const Dict& rhs);
+bool operator!=(const Dict& lhs, const Dict& rhs);
+
 class ParsingError : public std::runtime_error {
 public:
     using runtime_error::runtime_error;
 };
 
-class Node final : private std::variant<std::nullptr_t, Array, Dict, bool, int, double, std::string> {
+// Строка узла либо своя (std::string), либо ссылается на буфер, который живёт дольше узла
+// (std::string_view) — так узлы хранят строки при разборе без копирования
+class Node final : private std::variant<std::nullptr_t, Array, Dict, bool, int, double, std::string, std::string_view> {
 public:
     using variant::variant;
     using Value = variant;
@@ -34,7 +97,7 @@ public:
     int AsInt() const;
     bool AsBool() const;
     double AsDouble() const;
-    const std::string& AsString() const;
+    std::string_view AsString() const;
     const Array& AsArray() const;
     const Dict& AsMap() const;
     const Value& GetValue() const;
@@ -56,8 +119,132 @@ private:
 bool operator==(const Document& lhs, const Document& rhs);
 bool operator!=(const Document& lhs, const Document& rhs);
     
+// Обработчик событий потокового разбора: значения передаются в порядке следования в документе,
+// дерево узлов не строится. Ключи и строки действительны только на время вызова
+class Handler {
+public:
+    virtual ~Handler() = default;
+
+    virtual void StartArray() = 0;
+    virtual void EndArray() = 0;
+    virtual void StartDict() = 0;
+    // Ключ следующего значения словаря
+    virtual void Key(std::string_view key) = 0;
+    virtual void EndDict() = 0;
+    virtual void Null() = 0;
+    virtual void Bool(bool value) = 0;
+    virtual void Int(int value) = 0;
+    virtual void Double(double value) = 0;
+    virtual void String(std::string_view value) = 0;
+};
+
+// Хранилище строк с escape-последовательностями при разборе без копирования:
+// дек не перемещает строки, и ссылки на них остаются действительными
+using StringStorage = std::deque<std::string>;
+
+// Собирает дерево узлов из событий разбора; после завершения значения можно начать следующее
+class TreeBuilder : public Handler {
+public:
+    TreeBuilder() = default;
+    // Строки и ключи словарей, лежащие в input, хранятся в узлах ссылками без копирования,
+    // остальные добавляются в storage; input и storage должны жить дольше построенных узлов
+    TreeBuilder(std::string_view input, StringStorage& storage);
+
+    void StartArray() override;
+    void EndArray() override;
+    void StartDict() override;
+    // Выбрасывает ParsingError при повторе ключа
+    void Key(std::string_view key) override;
+    void EndDict() override;
+    void Null() override;
+    void Bool(bool value) override;
+    void Int(int value) override;
+    void Double(double value) override;
+    void String(std::string_view value) override;
+
+    // Собрано ли начатое значение целиком
+    bool IsComplete() const;
+    Node Build();
+
+private:
+    struct Frame {
+        bool is_dict = false;
+        Array array;
+        Dict dict;
+        DictKey key{std::string()};
+        // Место вставки значения с ключом key, найденное при проверке повтора
+        Dict::const_iterator position;
+    };
+
+    // Дек не перемещает открытые контейнеры, и position остаётся действительным
+    std::deque<Frame> frames_;
+    Node root_;
+    std::string_view input_;
+    StringStorage* storage_ = nullptr;
+
+    void AddValue(Node value);
+    // Ссылка на строку в input или на её копию в storage
+    std::string_view Keep(std::string_view value);
+};
+
+// Читает поток целиком
+std::string ReadAll(std::istream& input);
+// Разбирает буфер, передавая события обработчику
+void Parse(std::string_view input, Handler& handler);
+
+// Читает поток целиком и разбирает его как буфер
 Document Load(std::istream& input);
+// Разбирает непрерывный буфер, например отображённый в память файл
+Document Load(std::string_view input);
+// Разбирает буфер без копирования строк, как TreeBuilder(input, storage)
+Document Load(std::string_view input, StringStorage& storage);
+
+// Потоковая запись в формате Print без построения дерева узлов. Текст копится в буфере
+// и уходит в поток кусками по мере заполнения, при Flush и в деструкторе. Ключи словаря
+// пишутся в порядке вызовов: чтобы вывод совпал с Print, их передают по возрастанию
+class Writer {
+public:
+    explicit Writer(std::ostream& output);
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+    ~Writer();
+
+    Writer& StartArray();
+    Writer& EndArray();
+    Writer& StartDict();
+    Writer& Key(std::string_view key);
+    Writer& EndDict();
+    Writer& Value(std::nullptr_t);
+    Writer& Value(bool value);
+    Writer& Value(int value);
+    Writer& Value(double value);
+    Writer& Value(std::string_view value);
+    Writer& Value(const char* value);
+    // Записывает узел вместе с вложенными
+    Writer& WriteNode(const Node& node);
+    void Flush();
+
+private:
+    static constexpr size_t BUFFER_SIZE = 1 << 16;
+    static constexpr size_t INDENT_STEP = 4;
+
+    std::ostream& output_;
+    std::string buffer_;
+    // Для каждого открытого контейнера: записан ли в него хотя бы один элемент
+    std::vector<bool> has_items_;
+    bool is_after_key_ = false;
+
+    void BeginValue();
+    void EndContainer(char bracket);
+    void WriteIndent(size_t depth);
+    void WriteString(std::string_view value);
+};
 
 void Print(const Document& doc, std::ostream& output);
 
+// Число узлов дерева и занимаемая ими память в куче (без самого корневого узла
+// и без строк, на которые узлы только ссылаются)
+memory_stats::Usage GetMemoryUsage(const Node& node);
+memory_stats::Usage GetMemoryUsage(const StringStorage& storage);
+
 }  // namespace json
\ No newline at end of file
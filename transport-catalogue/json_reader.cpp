@@ -1,43 +1,340 @@
 #include "json_reader.h"
 
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <thread>
+
 namespace transport_catalogue {
 namespace json_reader {
 
 using namespace std::literals;
 
-JsonReader::JsonReader(std::istream& input) : data_(json::Load(input)) {
+namespace {
+
+// Число базовых запросов, которые проверяет один поток
+constexpr size_t BASE_REQUEST_CHUNK_SIZE = 1024;
+
+// Строит дерево документа, оставляя на месте массива root[key] пустой массив:
+// его элементы не хранятся, а читаются из входного буфера повторно через RootArrayReader.
+// Попутно считает в пропущенных запросах остановки, автобусы и расстояния.
+// Строки узлов ссылаются на input, как в TreeBuilder(input, storage)
+class TreeWithoutArrayBuilder final : public json::TreeBuilder {
+public:
+    TreeWithoutArrayBuilder(std::string_view key, std::string_view input, json::StringStorage& storage)
+        : TreeBuilder(input, storage), key_(key) {
+    }
+
+    const BaseRequestCounts& GetSkippedCounts() const {
+        return counts_;
+    }
+
+    void StartArray() override {
+        if (skipped_depth_ > 0 || (depth_ == 1 && is_key_selected_)) {
+            ++skipped_depth_;
+            return;
+        }
+        ++depth_;
+        TreeBuilder::StartArray();
+    }
+
+    void EndArray() override {
+        if (skipped_depth_ > 0) {
+            if (--skipped_depth_ == 0) {
+                TreeBuilder::StartArray();
+                TreeBuilder::EndArray();
+            }
+            return;
+        }
+        --depth_;
+        TreeBuilder::EndArray();
+    }
+
+    void StartDict() override {
+        if (skipped_depth_ > 0) {
+            ++skipped_depth_;
+            return;
+        }
+        ++depth_;
+        TreeBuilder::StartDict();
+    }
+
+    void EndDict() override {
+        if (skipped_depth_ > 0) {
+            --skipped_depth_;
+            return;
+        }
+        --depth_;
+        TreeBuilder::EndDict();
+    }
+
+    void Key(std::string_view key) override {
+        if (skipped_depth_ > 0) {
+            // Глубина 2 — поля запроса, 3 — поля вложенного в запрос словаря
+            if (skipped_depth_ == 2) {
+                is_type_key_ = key == "type"sv;
+                is_distances_key_ = key == "road_distances"sv;
+            } else if (skipped_depth_ == 3 && is_distances_key_) {
+                ++counts_.distances;
+            }
+            return;
+        }
+        if (depth_ == 1) {
+            is_key_selected_ = key == key_;
+        }
+        TreeBuilder::Key(key);
+    }
+
+    void Null() override {
+        if (skipped_depth_ == 0) {
+            TreeBuilder::Null();
+        }
+    }
+
+    void Bool(bool value) override {
+        if (skipped_depth_ == 0) {
+            TreeBuilder::Bool(value);
+        }
+    }
+
+    void Int(int value) override {
+        if (skipped_depth_ == 0) {
+            TreeBuilder::Int(value);
+        }
+    }
+
+    void Double(double value) override {
+        if (skipped_depth_ == 0) {
+            TreeBuilder::Double(value);
+        }
+    }
+
+    void String(std::string_view value) override {
+        if (skipped_depth_ == 0) {
+            TreeBuilder::String(value);
+        } else if (skipped_depth_ == 2 && is_type_key_) {
+            counts_.stops += value == "Stop"sv;
+            counts_.buses += value == "Bus"sv;
+        }
+    }
+
+private:
+    std::string_view key_;
+    // Число открытых контейнеров вне пропускаемого массива и внутри него
+    int depth_ = 0;
+    int skipped_depth_ = 0;
+    bool is_key_selected_ = false;
+    bool is_type_key_ = false;
+    bool is_distances_key_ = false;
+    BaseRequestCounts counts_;
+};
+
+// Собирает в дерево по одному элементы массива root[key] и передаёт каждый callback
+// сразу после разбора; остальная часть документа пропускается. Строки элементов
+// ссылаются на input или добавляются в storage и переживают сам элемент
+template <typename Callback>
+class RootArrayReader final : public json::Handler {
+public:
+    RootArrayReader(std::string_view key, std::string_view input, json::StringStorage& storage, Callback callback)
+        : key_(key), callback_(std::move(callback)), item_(input, storage) {
+    }
+
+    void StartArray() override {
+        if (is_inside_array_) {
+            item_.StartArray();
+        } else if (depth_ == 1 && is_key_selected_) {
+            is_inside_array_ = true;
+        }
+        ++depth_;
+    }
+
+    void EndArray() override {
+        --depth_;
+        if (depth_ == 1) {
+            is_inside_array_ = false;
+        } else if (is_inside_array_) {
+            item_.EndArray();
+            OnItemEvent();
+        }
+    }
+
+    void StartDict() override {
+        if (is_inside_array_) {
+            item_.StartDict();
+        }
+        ++depth_;
+    }
+
+    void EndDict() override {
+        --depth_;
+        if (is_inside_array_) {
+            item_.EndDict();
+            OnItemEvent();
+        }
+    }
+
+    void Key(std::string_view key) override {
+        if (is_inside_array_) {
+            item_.Key(key);
+        } else if (depth_ == 1) {
+            is_key_selected_ = key == key_;
+        }
+    }
+
+    void Null() override {
+        if (is_inside_array_) {
+            item_.Null();
+            OnItemEvent();
+        }
+    }
+
+    void Bool(bool value) override {
+        if (is_inside_array_) {
+            item_.Bool(value);
+            OnItemEvent();
+        }
+    }
+
+    void Int(int value) override {
+        if (is_inside_array_) {
+            item_.Int(value);
+            OnItemEvent();
+        }
+    }
+
+    void Double(double value) override {
+        if (is_inside_array_) {
+            item_.Double(value);
+            OnItemEvent();
+        }
+    }
+
+    void String(std::string_view value) override {
+        if (is_inside_array_) {
+            item_.String(value);
+            OnItemEvent();
+        }
+    }
+
+private:
+    std::string_view key_;
+    Callback callback_;
+    json::TreeBuilder item_;
+    int depth_ = 0;
+    bool is_key_selected_ = false;
+    bool is_inside_array_ = false;
+
+    void OnItemEvent() {
+        if (item_.IsComplete()) {
+            callback_(item_.Build());
+        }
+    }
+};
+
+} // namespace
+
+JsonReader::JsonReader(std::istream& input) : input_(json::ReadAll(input)), data_(nullptr) {
+    TreeWithoutArrayBuilder builder("base_requests"sv, input_, strings_);
+    json::Parse(input_, builder);
+    data_ = json::Document(builder.Build());
+    base_request_counts_ = builder.GetSkippedCounts();
 }
 
-void JsonReader::LoadCatalogueData(TransportCatalogue& catalogue)  const {
+void JsonReader::LoadCatalogueData(TransportCatalogue& catalogue) {
     const auto it_end = data_.GetRoot().AsMap().end();
-    auto it = data_.GetRoot().AsMap().find("base_requests"s);
+    auto it = data_.GetRoot().AsMap().find("base_requests"sv);
     if (it != it_end) {
-        const auto& base_requests = it->second.AsArray();
-        LoadStopsData(catalogue, base_requests);
-        LoadStopsDistances(catalogue, base_requests);
-        LoadBusesData(catalogue, base_requests);
+        if (!it->second.IsArray()) {
+            throw std::invalid_argument("Invalid base request: base_requests is not an array"s);
+        }
+        // Запросы добавляются в каталог по одному по мере разбора, без дерева всего массива
+        catalogue.Reserve(catalogue.GetStopCount() + base_request_counts_.stops,
+                          catalogue.GetBusCount() + base_request_counts_.buses, base_request_counts_.distances);
+        CatalogueLoader loader(catalogue);
+        // Разобранные запросы копятся пачками: пачка проверяется в нескольких потоках и затем
+        // добавляется в каталог в одном. В памяти одновременно не больше одной пачки
+        const size_t chunk_size = BASE_REQUEST_CHUNK_SIZE * std::max(1u, std::thread::hardware_concurrency());
+        std::vector<json::Node> chunk;
+        chunk.reserve(chunk_size);
+        auto commit_chunk = [this, &loader, &chunk]() {
+            if (auto error = CheckBaseRequests(chunk); error.has_value()) {
+                throw std::invalid_argument("Invalid base request: "s + error.value());
+            }
+            for (const json::Node& request : chunk) {
+                LoadBaseRequest(loader, request.AsMap());
+            }
+            chunk.clear();
+        };
+        // Названия остановок и автобусов каталог принимает без копирования из input_ и strings_
+        RootArrayReader reader("base_requests"sv, input_, strings_, [&chunk, chunk_size, &commit_chunk](json::Node request) {
+            chunk.push_back(std::move(request));
+            if (chunk.size() == chunk_size) {
+                commit_chunk();
+            }
+        });
+        json::Parse(input_, reader);
+        commit_chunk();
+        loader.Finish();
+    } else {
+        catalogue.Freeze();
     }
 }
 
+std::optional<UpdateReport> JsonReader::ApplyUpdateRequests(TransportCatalogue& catalogue) const {
+    const auto it_end = data_.GetRoot().AsMap().end();
+    auto it = data_.GetRoot().AsMap().find("update_requests"sv);
+    if (it == it_end) {
+        return std::nullopt;
+    }
+    const auto& update_requests = it->second.AsArray();
+    for (const auto& update_request : update_requests) {
+        if (auto error = CheckUpdateRequest(update_request.AsMap()); error.has_value()) {
+            throw std::invalid_argument("Invalid update request: "s + error.value());
+        }
+    }
+    return catalogue.Update(LoadUpdateRequests(update_requests));
+}
+
 std::vector<Request> JsonReader::LoadStatRequests() const {
     std::vector<Request> result;
     const auto it_end = data_.GetRoot().AsMap().end();
-    auto it = data_.GetRoot().AsMap().find("stat_requests"s);
+    auto it = data_.GetRoot().AsMap().find("stat_requests"sv);
     if (it != it_end) {
         const auto& stat_requests = it->second.AsArray();
+        result.reserve(stat_requests.size());
         for (const auto& stat_request : stat_requests) {
             const auto& map = stat_request.AsMap();
             if (auto error = CheckStatRequest(map); error.has_value()) {
                 throw std::invalid_argument("Invalid stat request: "s + error.value());
             }
             Request request;
-            request.id = map.at("id"s).AsInt();
-            request.type = map.at("type"s).AsString();
-            if (request.type == "Bus"s || request.type == "Stop"s) {
-                request.name = map.at("name"s).AsString();
+            request.id = map.at("id"sv).AsInt();
+            request.type = map.at("type"sv).AsString();
+            if (request.type == "Bus"sv || request.type == "Stop"sv) {
+                request.name = map.at("name"sv).AsString();
+            }
+            if (request.type == "Route"sv) {
+                if (map.at("from"sv).IsMap()) {
+                    request.route_points = {LoadRoutePoint(map.at("from"sv).AsMap()),
+                                            LoadRoutePoint(map.at("to"sv).AsMap())};
+                } else {
+                    request.route = {map.at("from"sv).AsString(), map.at("to"sv).AsString()};
+                }
+            }
+            if (request.type == "NearestStops"sv) {
+                request.coordinates = {map.at("latitude"sv).AsDouble(), map.at("longitude"sv).AsDouble()};
+                request.count = map.at("count"sv).AsInt();
+            }
+            if (request.type == "Suggest"sv) {
+                request.name = map.at("prefix"sv).AsString();
+                request.count = map.at("count"sv).AsInt();
+                if (auto it = map.find("max_errors"sv); it != map.end()) {
+                    request.max_errors = it->second.AsInt();
+                }
             }
-            if (request.type == "Route"s) {
-                request.route = {map.at("from"s).AsString(), map.at("to"s).AsString()};
+            if (request.type == "StopsInBox"sv) {
+                request.box.min = {map.at("min_latitude"sv).AsDouble(), map.at("min_longitude"sv).AsDouble()};
+                request.box.max = {map.at("max_latitude"sv).AsDouble(), map.at("max_longitude"sv).AsDouble()};
             }
             result.push_back(request);
         }
@@ -49,24 +346,24 @@ std::vector<Request> JsonReader::LoadStatRequests() const {
 map_renderer::RenderSettings JsonReader::LoadRenderSettings() const {
     map_renderer::RenderSettings result;
     const auto it_end = data_.GetRoot().AsMap().end();
-    auto it = data_.GetRoot().AsMap().find("render_settings"s);
+    auto it = data_.GetRoot().AsMap().find("render_settings"sv);
     if (it != it_end) {
         const auto& render_settings = it->second.AsMap();
         if (auto error = CheckRenderSettings(render_settings); error.has_value()) {
             throw std::invalid_argument("Invalid render settings: "s + error.value());
         }
-        result.width = render_settings.at("width"s).AsDouble();
-        result.height = render_settings.at("height"s).AsDouble();
-        result.padding = render_settings.at("padding"s).AsDouble();
-        result.line_width = render_settings.at("line_width"s).AsDouble();
-        result.stop_radius = render_settings.at("stop_radius"s).AsDouble();
-        result.bus_label_font_size = render_settings.at("bus_label_font_size"s).AsInt();
-        result.bus_label_offset = LoadRenderOffset(render_settings.at("bus_label_offset"s).AsArray());
-        result.stop_label_font_size = render_settings.at("stop_label_font_size"s).AsInt();
-        result.stop_label_offset = LoadRenderOffset(render_settings.at("stop_label_offset"s).AsArray());
-        result.underlayer_color = LoadRenderColor(render_settings.at("underlayer_color"s));
-        result.underlayer_width = render_settings.at("underlayer_width"s).AsDouble();
-        result.color_palette = LoadRenderColorPalette(render_settings.at("color_palette"s).AsArray());
+        result.width = render_settings.at("width"sv).AsDouble();
+        result.height = render_settings.at("height"sv).AsDouble();
+        result.padding = render_settings.at("padding"sv).AsDouble();
+        result.line_width = render_settings.at("line_width"sv).AsDouble();
+        result.stop_radius = render_settings.at("stop_radius"sv).AsDouble();
+        result.bus_label_font_size = render_settings.at("bus_label_font_size"sv).AsInt();
+        result.bus_label_offset = LoadRenderOffset(render_settings.at("bus_label_offset"sv).AsArray());
+        result.stop_label_font_size = render_settings.at("stop_label_font_size"sv).AsInt();
+        result.stop_label_offset = LoadRenderOffset(render_settings.at("stop_label_offset"sv).AsArray());
+        result.underlayer_color = LoadRenderColor(render_settings.at("underlayer_color"sv));
+        result.underlayer_width = render_settings.at("underlayer_width"sv).AsDouble();
+        result.color_palette = LoadRenderColorPalette(render_settings.at("color_palette"sv).AsArray());
     }
 
     return result;
@@ -75,53 +372,81 @@ map_renderer::RenderSettings JsonReader::LoadRenderSettings() const {
 transport_router::RouterSettings JsonReader::LoadRouterSettings() const {
     transport_router::RouterSettings result;
     const auto it_end = data_.GetRoot().AsMap().end();
-    auto it = data_.GetRoot().AsMap().find("routing_settings"s);
+    auto it = data_.GetRoot().AsMap().find("routing_settings"sv);
     if (it != it_end) {
         const auto& routing_settings = it->second.AsMap();
         if (auto error = CheckRouterSettings(routing_settings); error.has_value()) {
             throw std::invalid_argument("Invalid routing settings: "s + error.value());
         }
-        result.bus_wait_time = routing_settings.at("bus_wait_time"s).AsInt();
-        result.bus_velocity = routing_settings.at("bus_velocity"s).AsDouble();
+        result.bus_wait_time = routing_settings.at("bus_wait_time"sv).AsInt();
+        result.bus_velocity = routing_settings.at("bus_velocity"sv).AsDouble();
+        if (auto walk_it = routing_settings.find("walk_velocity"sv); walk_it != routing_settings.end()) {
+            result.walk_velocity = walk_it->second.AsDouble();
+        }
+        if (auto walk_it = routing_settings.find("max_walk_distance"sv); walk_it != routing_settings.end()) {
+            result.max_walk_distance = walk_it->second.AsDouble();
+        }
     }
     return result;
 }
 
-json::Document JsonReader::RenderAnswersJson(const request_handler::RequestHandler& handler, const std::vector<Request>& requests) const {
-    json::Builder builder;
+serialization::SerializationSettings JsonReader::LoadSerializationSettings() const {
+    const auto it_end = data_.GetRoot().AsMap().end();
+    auto it = data_.GetRoot().AsMap().find("serialization_settings"sv);
+    if (it == it_end || !it->second.IsMap()) {
+        throw std::invalid_argument("Serialization settings are not found"s);
+    }
+    const auto& serialization_settings = it->second.AsMap();
+    auto file_it = serialization_settings.find("file"sv);
+    if (!(file_it != serialization_settings.end() && file_it->second.IsString())) {
+        throw std::invalid_argument("Invalid serialization settings: The file is not found or has an incorrect format"s);
+    }
+    return {std::string(file_it->second.AsString())};
+}
 
-    builder.StartArray();
+void JsonReader::WriteAnswersJson(const request_handler::RequestHandler& handler, const std::vector<Request>& requests,
+                                  std::ostream& output) const {
+    json::Writer writer(output);
+
+    writer.StartArray();
     for (const auto& request : requests) {
-        if (request.type == "Bus"s) {
-            builder.Value(GetBusJsonData(handler, request));
-        } else if (request.type == "Stop"s) {
-            builder.Value(GetStopJsonData(handler, request));
-        } else if (request.type == "Map"s) {
-            builder.Value(GetMapJsonData(handler, request));
-        } else if (request.type == "Route"s) {
-            builder.Value(GetRouteJsonData(handler, request));
+        if (request.type == "Bus"sv) {
+            WriteBusAnswer(writer, handler, request);
+        } else if (request.type == "Stop"sv) {
+            WriteStopAnswer(writer, handler, request);
+        } else if (request.type == "Map"sv) {
+            WriteMapAnswer(writer, handler, request);
+        } else if (request.type == "Route"sv) {
+            WriteRouteAnswer(writer, handler, request);
+        } else if (request.type == "NearestStops"sv) {
+            WriteNearestStopsAnswer(writer, handler, request);
+        } else if (request.type == "StopsInBox"sv) {
+            WriteStopsInBoxAnswer(writer, handler, request);
+        } else if (request.type == "Suggest"sv) {
+            WriteSuggestAnswer(writer, handler, request);
+        } else if (request.type == "MemoryStats"sv) {
+            WriteMemoryStatsAnswer(writer, handler, request);
         }
     }
-    builder.EndArray();
-
-    return json::Document(builder.Build());
+    writer.EndArray();
+    writer.Flush();
 }
 
 std::optional<std::string> JsonReader::CheckStopData(const json::Dict& stop) const {
     const auto it_end = stop.end();
-    auto it = stop.find("name"s);
+    auto it = stop.find("name"sv);
     if (!(it != it_end && it->second.IsString())) {
         return "The stop name is not found or has an incorrect format"s;
     }
-    it = stop.find("latitude"s);
+    it = stop.find("latitude"sv);
     if (!(it != it_end && it->second.IsDouble())) {
         return "The stop latitude is not found or has an incorrect format"s; 
     }
-    it = stop.find("longitude"s);
+    it = stop.find("longitude"sv);
     if (!(it != it_end && it->second.IsDouble())) {
         return "The stop longitude is not found or has an incorrect format"s;
     }
-    it = stop.find("road_distances"s);
+    it = stop.find("road_distances"sv);
     if (!(it != it_end && CheckStopDistances(it->second.AsMap()))) {
         return "The stop road_distances is not found or has an incorrect format"s;
     }
@@ -139,15 +464,15 @@ bool JsonReader::CheckStopDistances(const json::Dict& distances) const {
 
 std::optional<std::string> JsonReader::CheckBusData(const json::Dict& bus) const {
     const auto it_end = bus.end();
-    auto it = bus.find("name"s);
+    auto it = bus.find("name"sv);
     if (!(it != it_end && it->second.IsString())) {
         return "The bus name is not found or has an incorrect format"s;
     }
-    it = bus.find("stops"s);
+    it = bus.find("stops"sv);
     if (!(it != it_end && CheckBusStops(it->second.AsArray()))) {
         return "The bus stops is not found or has an incorrect format"s;
     }
-    it = bus.find("is_roundtrip"s);
+    it = bus.find("is_roundtrip"sv);
     if (!(it != it_end && it->second.IsBool())) {
         return "The bus is_roundtrip is not found or has an incorrect format"s;
     }
@@ -165,29 +490,86 @@ bool JsonReader::CheckBusStops(const json::Array& stops) const {
 
 std::optional<std::string> JsonReader::CheckStatRequest(const json::Dict& request) const {
     const auto it_end = request.end();
-    auto it = request.find("id"s);
+    auto it = request.find("id"sv);
     if (!(it != it_end && it->second.IsInt())) {
         return "Id is not found or has an incorrect format"s;
     }
-    it = request.find("type"s);
+    it = request.find("type"sv);
     if (!(it != it_end && it->second.IsString())) {
         return "Type is not found or has an incorrect format"s;
     }
-    if (it->second.AsString() == "Stop"s || it->second.AsString() == "Bus"s) {
-        it = request.find("name"s);
+    std::string_view type = it->second.AsString();
+    if (type == "Stop"sv || type == "Bus"sv) {
+        it = request.find("name"sv);
         if (!(it != it_end && it->second.IsString())) {
             return "Stop/Bus name is not found or has an incorrect format"s;
         }
     }
-    if (it->second.AsString() == "Route"s) {
-        it = request.find("from"s);
-        if (!(it != it_end && it->second.IsString())) {
+    if (type == "Route"sv) {
+        it = request.find("from"sv);
+        if (!(it != it_end && (it->second.IsString() || it->second.IsMap()))) {
             return "From for route is not found or has an incorrect format"s;
         }
-        it = request.find("to"s);
-        if (!(it != it_end && it->second.IsString())) {
+        const bool by_points = it->second.IsMap();
+        if (by_points) {
+            if (auto error = CheckRoutePoint(it->second); error.has_value()) {
+                return "From for route: "s + error.value();
+            }
+        }
+        it = request.find("to"sv);
+        if (!(it != it_end && (by_points ? it->second.IsMap() : it->second.IsString()))) {
             return "To for route is not found or has an incorrect format"s;
         }
+        if (by_points) {
+            if (auto error = CheckRoutePoint(it->second); error.has_value()) {
+                return "To for route: "s + error.value();
+            }
+        }
+    }
+    if (type == "NearestStops"sv) {
+        for (std::string_view key : {"latitude"sv, "longitude"sv}) {
+            it = request.find(key);
+            if (!(it != it_end && it->second.IsDouble())) {
+                return "The "s + std::string(key) + " for nearest stops is not found or has an incorrect format"s;
+            }
+        }
+        it = request.find("count"sv);
+        if (!(it != it_end && it->second.IsInt() && it->second.AsInt() >= 0)) {
+            return "The count for nearest stops is not found or has an incorrect format"s;
+        }
+    }
+    if (type == "Suggest"sv) {
+        it = request.find("prefix"sv);
+        if (!(it != it_end && it->second.IsString())) {
+            return "The prefix for suggest is not found or has an incorrect format"s;
+        }
+        it = request.find("count"sv);
+        if (!(it != it_end && it->second.IsInt() && it->second.AsInt() >= 0)) {
+            return "The count for suggest is not found or has an incorrect format"s;
+        }
+        it = request.find("max_errors"sv);
+        if (it != it_end && !(it->second.IsInt() && it->second.AsInt() >= 0)) {
+            return "The max_errors for suggest has an incorrect format"s;
+        }
+    }
+    if (type == "StopsInBox"sv) {
+        for (std::string_view key : {"min_latitude"sv, "min_longitude"sv, "max_latitude"sv, "max_longitude"sv}) {
+            it = request.find(key);
+            if (!(it != it_end && it->second.IsDouble())) {
+                return "The "s + std::string(key) + " for stops in box is not found or has an incorrect format"s;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> JsonReader::CheckRoutePoint(const json::Node& point) const {
+    const auto& map = point.AsMap();
+    for (std::string_view key : {"latitude"sv, "longitude"sv}) {
+        auto it = map.find(key);
+        if (!(it != map.end() && it->second.IsDouble())) {
+            return "The "s + std::string(key) + " is not found or has an incorrect format"s;
+        }
     }
     return std::nullopt;
 }
@@ -196,7 +578,7 @@ namespace detail {
     
     std::optional<std::string> CheckWidth(const json::Dict& settings) {
         const auto it_end = settings.end();
-        auto it = settings.find("width"s);
+        auto it = settings.find("width"sv);
         if (!(it != it_end && it->second.IsDouble())) {
             return "The width is not found or has an incorrect format"s;
         }
@@ -209,7 +591,7 @@ namespace detail {
 
     std::optional<std::string> CheckHeight(const json::Dict& settings) {
         const auto it_end = settings.end();
-        auto it = settings.find("height"s);
+        auto it = settings.find("height"sv);
         if (!(it != it_end && it->second.IsDouble())) {
             return "The height is not found or has an incorrect format"s;
         }
@@ -222,12 +604,12 @@ namespace detail {
 
     std::optional<std::string> CheckPadding(const json::Dict& settings) {
         const auto it_end = settings.end();
-        auto it = settings.find("padding"s);
+        auto it = settings.find("padding"sv);
         if (!(it != it_end && it->second.IsDouble())) {
             return "The padding is not found or has an incorrect format"s;
         }
         double padding = it->second.AsDouble();
-        if (!(padding >= 0.0 && padding < std::min(settings.at("width"s).AsDouble(), settings.at("height"s).AsDouble()) / 2)) {
+        if (!(padding >= 0.0 && padding < std::min(settings.at("width"sv).AsDouble(), settings.at("height"sv).AsDouble()) / 2)) {
             return "The padding is out of range"s;
         }
         return std::nullopt;
@@ -235,7 +617,7 @@ namespace detail {
 
     std::optional<std::string> CheckLineWidth(const json::Dict& settings) {
         const auto it_end = settings.end();
-        auto it = settings.find("line_width"s);
+        auto it = settings.find("line_width"sv);
         if (!(it != it_end && it->second.IsDouble())) {
             return "The line_width is not found or has an incorrect format"s;
         }
@@ -248,7 +630,7 @@ namespace detail {
 
     std::optional<std::string> CheckStopRadius(const json::Dict& settings) {
         const auto it_end = settings.end();
-        auto it = settings.find("stop_radius"s);
+        auto it = settings.find("stop_radius"sv);
         if (!(it != it_end && it->second.IsDouble())) {
             return "The stop_radius is not found or has an incorrect format"s;
         }
@@ -261,7 +643,7 @@ namespace detail {
 
     std::optional<std::string> CheckBusLabelFontSize(const json::Dict& settings) {
         const auto it_end = settings.end();
-        auto it = settings.find("bus_label_font_size"s);
+        auto it = settings.find("bus_label_font_size"sv);
         if (!(it != it_end && it->second.IsInt())) {
             return "The bus_label_font_size is not found or has an incorrect format"s;
         }
@@ -274,7 +656,7 @@ namespace detail {
 
     std::optional<std::string> CheckBusLabelOffset(const json::Dict& settings) {
         const auto it_end = settings.end();
-        auto it = settings.find("bus_label_offset"s);
+        auto it = settings.find("bus_label_offset"sv);
         if (!(it != it_end && it->second.IsArray())) {
             return "The bus_label_offset is not found or has an incorrect format"s;
         }
@@ -292,7 +674,7 @@ namespace detail {
 
     std::optional<std::string> CheckStopLabelFontSize(const json::Dict& settings) {
         const auto it_end = settings.end();
-        auto it = settings.find("stop_label_font_size"s);
+        auto it = settings.find("stop_label_font_size"sv);
         if (!(it != it_end && it->second.IsInt())) {
             return "The stop_label_font_size is not found or has an incorrect format"s;
         }
@@ -305,7 +687,7 @@ namespace detail {
 
     std::optional<std::string> CheckStopLabelOffset(const json::Dict& settings) {
         const auto it_end = settings.end();
-        auto it = settings.find("stop_label_offset"s);
+        auto it = settings.find("stop_label_offset"sv);
         if (!(it != it_end && it->second.IsArray())) {
             return "The stop_label_offset is not found or has an incorrect format"s;
         }
@@ -351,7 +733,7 @@ namespace detail {
 
     std::optional<std::string> CheckUnderlayerColor(const json::Dict& settings) {
         const auto it_end = settings.end();
-        auto it = settings.find("underlayer_color"s);
+        auto it = settings.find("underlayer_color"sv);
         if (it == it_end) {
             return "The underlayer_color is not found"s;
         }
@@ -363,7 +745,7 @@ namespace detail {
 
     std::optional<std::string> CheckUnderlayerWidth(const json::Dict& settings) {
         const auto it_end = settings.end();
-        auto it = settings.find("underlayer_width"s);
+        auto it = settings.find("underlayer_width"sv);
         if (!(it != it_end && it->second.IsDouble())) {
             return "The underlayer_width is not found or has an incorrect format"s;
         }
@@ -376,7 +758,7 @@ namespace detail {
 
     std::optional<std::string> CheckColorPalette(const json::Dict& settings) {
         const auto it_end = settings.end();
-        auto it = settings.find("color_palette"s);
+        auto it = settings.find("color_palette"sv);
         if (!(it != it_end && it->second.IsArray())) {
             return "The color_palette is not found or has an incorrect format"s;
         }
@@ -410,7 +792,7 @@ namespace detail {
 
 std::optional<std::string> CheckBusWaitTime(const json::Dict& settings) {
     const auto it_end = settings.end();
-    auto it = settings.find("bus_wait_time"s);
+    auto it = settings.find("bus_wait_time"sv);
     if (!(it != it_end && it->second.IsInt())) {
         return "The bus_wait_time is not found or has an incorrect format"s;
     }
@@ -423,7 +805,7 @@ std::optional<std::string> CheckBusWaitTime(const json::Dict& settings) {
 
 std::optional<std::string> CheckBusVelocity(const json::Dict& settings) {
     const auto it_end = settings.end();
-    auto it = settings.find("bus_velocity"s);
+    auto it = settings.find("bus_velocity"sv);
     if (!(it != it_end && it->second.IsDouble())) {
         return "The bus_velocity is not found or has an incorrect format"s;
     }
@@ -434,87 +816,189 @@ std::optional<std::string> CheckBusVelocity(const json::Dict& settings) {
     return std::nullopt;
 }
 
+// Необязательные настройки пеших участков маршрута
+std::optional<std::string> CheckWalkSettings(const json::Dict& settings) {
+    const auto it_end = settings.end();
+    auto it = settings.find("walk_velocity"sv);
+    if (it != it_end) {
+        if (!it->second.IsDouble()) {
+            return "The walk_velocity has an incorrect format"s;
+        }
+        double walk_velocity = it->second.AsDouble();
+        if (!(walk_velocity >= 1.0 && walk_velocity <= 100.0)) {
+            return "The walk_velocity is out of range"s;
+        }
+    }
+    it = settings.find("max_walk_distance"sv);
+    if (it != it_end) {
+        if (!it->second.IsDouble()) {
+            return "The max_walk_distance has an incorrect format"s;
+        }
+        double max_walk_distance = it->second.AsDouble();
+        if (!(max_walk_distance >= 0.0 && max_walk_distance <= 100000.0)) {
+            return "The max_walk_distance is out of range"s;
+        }
+    }
+    return std::nullopt;
+}
+
 } // namespace detail
 
 std::optional<std::string> JsonReader::CheckRouterSettings(const json::Dict& settings) const {
     if (auto error = detail::CheckBusWaitTime(settings); error.has_value()) {return error;}
     if (auto error = detail::CheckBusVelocity(settings); error.has_value()) {return error;}
+    if (auto error = detail::CheckWalkSettings(settings); error.has_value()) {return error;}
     return std::nullopt;
 }
 
-void JsonReader::LoadStopsData(TransportCatalogue& catalogue, const json::Array& requests) const {
-    for (const auto& request : requests) {
-        const auto& map = request.AsMap();
-        const auto it_end = map.end();
-        auto it = map.find("type"s);
-        if (!(it != it_end && it->second.IsString())) {
-            throw std::invalid_argument("Invalid base request: Invalid type"s);
-        }
+std::optional<std::string> JsonReader::CheckBaseRequest(const json::Node& request) const {
+    const auto& map = request.AsMap();
+    const auto it_end = map.end();
+    auto it = map.find("type"sv);
+    if (!(it != it_end && it->second.IsString())) {
+        return "Invalid type"s;
+    }
+    if (it->second.AsString() == "Stop"sv) {
+        return CheckStopData(map);
+    }
+    if (it->second.AsString() == "Bus"sv) {
+        return CheckBusData(map);
+    }
+    return std::nullopt;
+}
 
-        if (it->second.AsString() == "Stop"s) {
-            if (auto error = CheckStopData(map); error.has_value()) {
-                throw std::invalid_argument("Invalid base request: "s + error.value());
+std::optional<std::string> JsonReader::CheckBaseRequests(const std::vector<json::Node>& requests) const {
+    // Части по BASE_REQUEST_CHUNK_SIZE запросов проверяются в отдельных потоках, первая — в текущем.
+    // Части просматриваются по порядку, поэтому сообщается первая ошибка в документе
+    auto check = [this, &requests](size_t begin, size_t end) -> std::optional<std::string> {
+        for (size_t i = begin; i < end; ++i) {
+            if (auto error = CheckBaseRequest(requests[i]); error.has_value()) {
+                return error;
             }
-            LoadStopData(catalogue, map);
         }
+        return std::nullopt;
+    };
+    std::vector<std::future<std::optional<std::string>>> results;
+    for (size_t begin = BASE_REQUEST_CHUNK_SIZE; begin < requests.size(); begin += BASE_REQUEST_CHUNK_SIZE) {
+        results.push_back(std::async(std::launch::async, check, begin,
+                                     std::min(requests.size(), begin + BASE_REQUEST_CHUNK_SIZE)));
     }
-}
-
-void JsonReader::LoadStopData(TransportCatalogue& catalogue, const json::Dict& stop) const {
-    geo::Coordinates coordinates = {stop.at("latitude"s).AsDouble(), stop.at("longitude"s).AsDouble()};
-    catalogue.AddStop({stop.at("name"s).AsString(), coordinates});
-}
-
-void JsonReader::LoadStopsDistances(TransportCatalogue& catalogue, const json::Array& requests) const {
-    for (const auto& request : requests) {
-        const auto& map = request.AsMap();
-        if (map.at("type"s) == "Stop"s) {
-            LoadStopDistances(catalogue, map.at("name"s).AsString(), map.at("road_distances"s).AsMap());
+    auto error = check(0, std::min(requests.size(), BASE_REQUEST_CHUNK_SIZE));
+    for (auto& result : results) {
+        // Дожидаемся всех потоков: они читают requests
+        auto chunk_error = result.get();
+        if (!error.has_value()) {
+            error = std::move(chunk_error);
         }
     }
+    return error;
 }
 
-void JsonReader::LoadStopDistances(TransportCatalogue& catalogue, const std::string& from, const json::Dict& distances) const {
-    for (const auto& [to, distance] : distances) {
-        catalogue.AddDistance(from, to, distance.AsInt());
+// Запрос обновления добавляет или изменяет объект, а с "action": "remove" — удаляет его
+std::optional<std::string> JsonReader::CheckUpdateRequest(const json::Dict& request) const {
+    const auto it_end = request.end();
+    auto it = request.find("type"sv);
+    if (!(it != it_end && it->second.IsString())) {
+        return "Invalid type"s;
+    }
+    std::string_view type = it->second.AsString();
+    bool is_removal = false;
+    if (auto action_it = request.find("action"sv); action_it != it_end) {
+        if (!(action_it->second.IsString()
+                && (action_it->second.AsString() == "set"sv || action_it->second.AsString() == "remove"sv))) {
+            return "The action is not \"set\" or \"remove\""s;
+        }
+        is_removal = action_it->second.AsString() == "remove"sv;
+    }
+    if (type == "Stop"sv || type == "Bus"sv) {
+        if (!is_removal) {
+            return type == "Stop"sv ? CheckStopData(request) : CheckBusData(request);
+        }
+        it = request.find("name"sv);
+        if (!(it != it_end && it->second.IsString())) {
+            return "The "s + (type == "Stop"sv ? "stop"s : "bus"s) + " name is not found or has an incorrect format"s;
+        }
+        return std::nullopt;
+    }
+    if (type == "Distance"sv) {
+        for (std::string_view key : {"from"sv, "to"sv}) {
+            it = request.find(key);
+            if (!(it != it_end && it->second.IsString())) {
+                return "The distance "s + std::string(key) + " is not found or has an incorrect format"s;
+            }
+        }
+        it = request.find("distance"sv);
+        if (!is_removal && !(it != it_end && it->second.IsInt() && it->second.AsInt() >= 0)) {
+            return "The distance is not found or has an incorrect format"s;
+        }
+        return std::nullopt;
     }
+    return "Invalid type"s;
 }
 
-void JsonReader::LoadBusesData(TransportCatalogue& catalogue, const json::Array& requests) const {
+CatalogueUpdate JsonReader::LoadUpdateRequests(const json::Array& requests) const {
+    CatalogueUpdate update;
     for (const auto& request : requests) {
         const auto& map = request.AsMap();
-        if (map.at("type"s) == "Bus"s) {
-            if (auto error = CheckBusData(map); error.has_value()) {
-                throw std::invalid_argument("Invalid base request: "s + error.value());
+        const auto& type = map.at("type"sv).AsString();
+        auto action_it = map.find("action"sv);
+        const bool is_removal = action_it != map.end() && action_it->second.AsString() == "remove"sv;
+        if (type == "Stop"sv) {
+            if (is_removal) {
+                update.removed_stops.push_back(map.at("name"sv).AsString());
+            } else {
+                LoadStopData(update.data, map);
+            }
+        } else if (type == "Bus"sv) {
+            if (is_removal) {
+                update.removed_buses.push_back(map.at("name"sv).AsString());
+            } else {
+                LoadBusData(update.data, map);
+            }
+        } else if (type == "Distance"sv) {
+            std::string_view from = map.at("from"sv).AsString();
+            std::string_view to = map.at("to"sv).AsString();
+            if (is_removal) {
+                update.removed_distances.emplace_back(from, to);
+            } else {
+                update.data.distances.push_back({from, to, map.at("distance"sv).AsInt()});
             }
-            LoadBusData(catalogue, map);
         }
     }
+    return update;
 }
 
-void JsonReader::LoadBusData(TransportCatalogue& catalogue, const json::Dict& bus) const {
-    std::vector<std::string> route;
-
-    if (bus.at("is_roundtrip"s).AsBool()) {
-        for (const auto& stop : bus.at("stops"s).AsArray()) {
-            route.push_back(stop.AsString());
+void JsonReader::LoadBaseRequest(CatalogueLoader& loader, const json::Dict& request) {
+    const auto& type = request.at("type"sv).AsString();
+    if (type == "Stop"sv) {
+        std::string_view name = request.at("name"sv).AsString();
+        loader.AddStop({name, {request.at("latitude"sv).AsDouble(), request.at("longitude"sv).AsDouble()}});
+        for (const auto& [to, distance] : request.at("road_distances"sv).AsMap()) {
+            loader.AddDistance(name, to, distance.AsInt());
         }
-    } else {
-        const auto& array = bus.at("stops"s).AsArray();
-        for (const auto& stop : array) {
-            route.push_back(stop.AsString());
-        }
-        for (int i = array.size() - 2; i >= 0; --i) {
-            route.push_back(array[i].AsString());
+    } else if (type == "Bus"sv) {
+        bus_stops_.clear();
+        for (const auto& stop : request.at("stops"sv).AsArray()) {
+            bus_stops_.push_back(stop.AsString());
         }
+        loader.AddBus(request.at("name"sv).AsString(), bus_stops_, request.at("is_roundtrip"sv).AsBool());
     }
+}
 
-    std::vector<Stop*> stops;
-    for (const std::string& stop : route) {
-        stops.push_back(catalogue.FindStop(stop));
+void JsonReader::LoadStopData(CatalogueData& data, const json::Dict& stop) const {
+    std::string_view name = stop.at("name"sv).AsString();
+    data.stops.push_back({name, {stop.at("latitude"sv).AsDouble(), stop.at("longitude"sv).AsDouble()}});
+    for (const auto& [to, distance] : stop.at("road_distances"sv).AsMap()) {
+        data.distances.push_back({name, to, distance.AsInt()});
     }
+}
 
-    catalogue.AddBus({bus.at("name"s).AsString(), stops, bus.at("is_roundtrip"s).AsBool()});
+void JsonReader::LoadBusData(CatalogueData& data, const json::Dict& bus) const {
+    const size_t stops_begin = data.bus_stops.size();
+    for (const auto& stop : bus.at("stops"sv).AsArray()) {
+        data.bus_stops.push_back(stop.AsString());
+    }
+    data.buses.push_back({bus.at("name"sv).AsString(), stops_begin, data.bus_stops.size(), bus.at("is_roundtrip"sv).AsBool()});
 }
 
 svg::Point JsonReader::LoadRenderOffset(const json::Array& offset) const {
@@ -523,7 +1007,7 @@ svg::Point JsonReader::LoadRenderOffset(const json::Array& offset) const {
 
 svg::Color JsonReader::LoadRenderColor(const json::Node& color) const {
     if (color.IsString()) {
-        return color.AsString();
+        return std::string(color.AsString());
     }
     if (color.IsArray()) {
         const auto& array = color.AsArray();
@@ -538,86 +1022,175 @@ svg::Color JsonReader::LoadRenderColor(const json::Node& color) const {
 
 std::vector<svg::Color> JsonReader::LoadRenderColorPalette(const json::Array& pallete) const {
     std::vector<svg::Color> result;
-
+    result.reserve(pallete.size());
     for (const auto& color : pallete) {
         result.push_back(LoadRenderColor(color));
     }
     return result;
 }
 
-json::Node JsonReader::GetBusJsonData(const request_handler::RequestHandler& handler, const Request& request) const {
-    json::Builder builder;
-    
-    builder.StartDict().Key("request_id"s).Value(request.id);
+geo::Coordinates JsonReader::LoadRoutePoint(const json::Dict& point) const {
+    return {point.at("latitude"sv).AsDouble(), point.at("longitude"sv).AsDouble()};
+}
+
+// Ключи ответов пишутся по возрастанию, в том же порядке, в каком их выводит json::Print
+
+void JsonReader::WriteBusAnswer(json::Writer& writer, const request_handler::RequestHandler& handler,
+                                const Request& request) const {
+    writer.StartDict();
     auto bus_stat = handler.GetBusInfo(request.name);
     if (bus_stat.has_value()) {
-        builder.Key("stop_count"s).Value(bus_stat.value().stops_count)
-               .Key("unique_stop_count"s).Value(bus_stat.value().unique_stops_count)
-               .Key("route_length"s).Value(bus_stat.value().route_length)
-               .Key("curvature"s).Value(bus_stat.value().curvature).EndDict();
+        writer.Key("curvature"sv).Value(bus_stat->curvature)
+              .Key("request_id"sv).Value(request.id)
+              .Key("route_length"sv).Value(bus_stat->route_length)
+              .Key("stop_count"sv).Value(bus_stat->stops_count)
+              .Key("unique_stop_count"sv).Value(bus_stat->unique_stops_count);
     } else {
-        builder.Key("error_message"s).Value("not found"s).EndDict();
+        writer.Key("error_message"sv).Value("not found"sv)
+              .Key("request_id"sv).Value(request.id);
     }
-
-    return builder.Build();
+    writer.EndDict();
 }
 
-json::Node JsonReader::GetStopJsonData(const request_handler::RequestHandler& handler, const Request& request) const {
-    json::Builder builder;
-
-    builder.StartDict().Key("request_id"s).Value(request.id);
+void JsonReader::WriteStopAnswer(json::Writer& writer, const request_handler::RequestHandler& handler,
+                                 const Request& request) const {
+    writer.StartDict();
     auto stop_stat = handler.GetStopInfo(request.name);
     if (stop_stat.has_value()) {
-        builder.Key("buses"s).StartArray();
-        for (auto bus : stop_stat.value()) {
-            builder.Value(std::string{bus});
+        writer.Key("buses"sv).StartArray();
+        for (BusId bus_id : stop_stat.value()) {
+            writer.Value(handler.GetBusName(bus_id));
         }
-        builder.EndArray().EndDict();
+        writer.EndArray();
     } else {
-        builder.Key("error_message"s).Value("not found"s).EndDict();
+        writer.Key("error_message"sv).Value("not found"sv);
     }
-
-    return builder.Build();
+    writer.Key("request_id"sv).Value(request.id).EndDict();
 }
 
-json::Node JsonReader::GetMapJsonData(const request_handler::RequestHandler& handler, const Request& request) const {
-    json::Builder builder;
-
-    builder.StartDict().Key("request_id"s).Value(request.id);
+void JsonReader::WriteMapAnswer(json::Writer& writer, const request_handler::RequestHandler& handler,
+                                const Request& request) const {
     auto map_svg = handler.RenderMap();
     std::stringstream strm;
     map_svg.Render(strm);
-    builder.Key("map"s).Value(strm.str()).EndDict();
-
-    return builder.Build();
+    writer.StartDict()
+          .Key("map"sv).Value(strm.str())
+          .Key("request_id"sv).Value(request.id)
+          .EndDict();
 }
 
-json::Node JsonReader::GetRouteJsonData(const request_handler::RequestHandler& handler, const Request& request) const {
-    json::Builder builder;
-
-    builder.StartDict().Key("request_id"s).Value(request.id);
-    auto route_stat = handler.GetRouteInfo(request.route.first, request.route.second);
+void JsonReader::WriteRouteAnswer(json::Writer& writer, const request_handler::RequestHandler& handler,
+                                  const Request& request) const {
+    writer.StartDict();
+    auto route_stat = request.route_points
+                    ? handler.GetRouteInfo(request.route_points->first, request.route_points->second)
+                    : handler.GetRouteInfo(request.route.first, request.route.second);
     if (route_stat.has_value()) {
-        builder.Key("total_time"s).Value(route_stat->total_time)
-               .Key("items").StartArray();
+        writer.Key("items"sv).StartArray();
         for (const auto& item : route_stat->items) {
-            builder.StartDict();
+            writer.StartDict();
             if (item.type == transport_router::EdgeType::WAIT) {
-                builder.Key("type"s).Value("Wait"s)
-                       .Key("stop_name"s).Value(std::string{item.name});
+                writer.Key("stop_name"sv).Value(item.name)
+                      .Key("time"sv).Value(item.time)
+                      .Key("type"sv).Value("Wait"sv);
             } else if (item.type == transport_router::EdgeType::BUS) {
-                builder.Key("type"s).Value("Bus"s)
-                       .Key("bus"s).Value(std::string{item.name})
-                       .Key("span_count"s).Value(*item.span_count);  
+                writer.Key("bus"sv).Value(item.name)
+                      .Key("span_count"sv).Value(*item.span_count)
+                      .Key("time"sv).Value(item.time)
+                      .Key("type"sv).Value("Bus"sv);
+            } else if (item.type == transport_router::EdgeType::WALK) {
+                if (!item.name.empty()) {
+                    writer.Key("stop_name"sv).Value(item.name);
+                }
+                writer.Key("time"sv).Value(item.time)
+                      .Key("type"sv).Value("Walk"sv);
             }
-            builder.Key("time"s).Value(item.time).EndDict();
+            writer.EndDict();
         }
-        builder.EndArray().EndDict();
+        writer.EndArray()
+              .Key("request_id"sv).Value(request.id)
+              .Key("total_time"sv).Value(route_stat->total_time);
+    } else {
+        writer.Key("error_message"sv).Value("not found"sv)
+              .Key("request_id"sv).Value(request.id);
+    }
+    writer.EndDict();
+}
+
+void JsonReader::WriteNearestStopsAnswer(json::Writer& writer, const request_handler::RequestHandler& handler,
+                                         const Request& request) const {
+    writer.StartDict()
+          .Key("request_id"sv).Value(request.id)
+          .Key("stops"sv).StartArray();
+    for (const auto& stop : handler.GetNearestStops(request.coordinates, request.count)) {
+        writer.StartDict()
+              .Key("distance"sv).Value(stop.distance)
+              .Key("name"sv).Value(handler.GetStopName(stop.id))
+              .EndDict();
+    }
+    writer.EndArray().EndDict();
+}
+
+void JsonReader::WriteStopsInBoxAnswer(json::Writer& writer, const request_handler::RequestHandler& handler,
+                                       const Request& request) const {
+    writer.StartDict()
+          .Key("request_id"sv).Value(request.id)
+          .Key("stops"sv).StartArray();
+    for (StopId stop_id : handler.GetStopsInBox(request.box)) {
+        writer.Value(handler.GetStopName(stop_id));
+    }
+    writer.EndArray().EndDict();
+}
+
+void JsonReader::WriteSuggestAnswer(json::Writer& writer, const request_handler::RequestHandler& handler,
+                                    const Request& request) const {
+    writer.StartDict()
+          .Key("items"sv).StartArray();
+    for (const auto& match : handler.GetNameSuggestions(request.name, request.count, request.max_errors)) {
+        writer.StartDict()
+              .Key("errors"sv).Value(match.errors)
+              .Key("name"sv).Value(match.name)
+              .Key("type"sv).Value(match.kind == NameKind::STOP ? "Stop"sv : "Bus"sv)
+              .EndDict();
+    }
+    writer.EndArray()
+          .Key("request_id"sv).Value(request.id)
+          .EndDict();
+}
+
+namespace {
+
+// Размеры больше INT_MAX выводятся числом с плавающей точкой
+void WriteSize(json::Writer& writer, size_t value) {
+    if (value <= static_cast<size_t>(std::numeric_limits<int>::max())) {
+        writer.Value(static_cast<int>(value));
     } else {
-        builder.Key("error_message"s).Value("not found"s).EndDict();
+        writer.Value(static_cast<double>(value));
     }
+}
 
-    return builder.Build();
+} // namespace
+
+void JsonReader::WriteMemoryStatsAnswer(json::Writer& writer, const request_handler::RequestHandler& handler,
+                                        const Request& request) const {
+    memory_stats::MemoryStats stats = handler.GetMemoryStats();
+    stats.Add("json.input", memory_stats::GetStringUsage(input_));
+    stats.Add("json.document", json::GetMemoryUsage(data_.GetRoot()));
+    stats.Add("json.escaped_strings", json::GetMemoryUsage(strings_));
+
+    writer.StartDict()
+          .Key("request_id"sv).Value(request.id)
+          .Key("structures"sv).StartArray();
+    for (const auto& [name, usage] : stats.GetEntries()) {
+        writer.StartDict().Key("bytes"sv);
+        WriteSize(writer, usage.bytes);
+        writer.Key("elements"sv);
+        WriteSize(writer, usage.elements);
+        writer.Key("name"sv).Value(name).EndDict();
+    }
+    writer.EndArray().Key("total_bytes"sv);
+    WriteSize(writer, stats.GetTotalBytes());
+    writer.EndDict();
 }
 
 } // json_reader
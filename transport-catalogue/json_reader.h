@@ -4,57 +4,99 @@
 #include <optional>
 #include <utility>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "catalogue_loader.h"
 #include "json.h"
-#include "json_builder.h"
 #include "map_renderer.h"
 #include "request_handler.h"
+#include "serialization.h"
 #include "transport_catalogue.h"
 #include "transport_router.h"
 
 namespace transport_catalogue {
 namespace json_reader {
 
+// Строки запроса ссылаются на документ JsonReader и действительны, пока он существует
 struct Request {
     int id;
-    std::string type;
-    std::string name;
-    std::pair<std::string, std::string> route;
+    std::string_view type;
+    std::string_view name;
+    std::pair<std::string_view, std::string_view> route;
+    // Начало и конец маршрута, заданные координатами вместо названий остановок
+    std::optional<std::pair<geo::Coordinates, geo::Coordinates>> route_points;
+    geo::Coordinates coordinates{};
+    int count = 0;
+    int max_errors = 0;
+    geo::BoundingBox box{};
+};
+
+// Число запросов-остановок, запросов-автобусов и расстояний в base_requests
+struct BaseRequestCounts {
+    size_t stops = 0;
+    size_t buses = 0;
+    size_t distances = 0;
 };
 
 class JsonReader {
 public:
     JsonReader(std::istream& input);
-    void LoadCatalogueData(TransportCatalogue& catalogue) const;
+    // Каталог ссылается на названия из входных данных: JsonReader должен жить дольше каталога
+    void LoadCatalogueData(TransportCatalogue& catalogue);
+    // Применяет update_requests к загруженному каталогу; nullopt, если их нет
+    std::optional<UpdateReport> ApplyUpdateRequests(TransportCatalogue& catalogue) const;
     std::vector<Request> LoadStatRequests() const;
     map_renderer::RenderSettings LoadRenderSettings() const;
     transport_router::RouterSettings LoadRouterSettings() const;
-    json::Document RenderAnswersJson(const request_handler::RequestHandler& handler, const std::vector<Request>& requests) const;
+    serialization::SerializationSettings LoadSerializationSettings() const;
+    // Пишет ответы на запросы в поток по мере их обработки, без построения дерева узлов
+    void WriteAnswersJson(const request_handler::RequestHandler& handler, const std::vector<Request>& requests,
+                          std::ostream& output) const;
 
 private:
+    // Входные данные целиком: массив base_requests читается из них потоково и в data_ не хранится
+    std::string input_;
+    // Строки с escape-последовательностями; остальные строки узлов ссылаются на input_
+    json::StringStorage strings_;
     json::Document data_;
+    // Подсчитаны при построении data_, чтобы каталог заранее зарезервировал память
+    BaseRequestCounts base_request_counts_;
+    // Остановки автобуса из base_requests: буфер очищается для каждого автобуса, но не освобождается
+    std::vector<std::string_view> bus_stops_;
 
     std::optional<std::string> CheckStopData(const json::Dict& stop) const;
     bool CheckStopDistances(const json::Dict& distances) const;
     std::optional<std::string> CheckBusData(const json::Dict& bus) const;
     bool CheckBusStops(const json::Array& stops) const;
     std::optional<std::string> CheckStatRequest(const json::Dict& request) const;
+    std::optional<std::string> CheckRoutePoint(const json::Node& point) const;
     std::optional<std::string> CheckRenderSettings(const json::Dict& settings) const;
     std::optional<std::string> CheckRouterSettings(const json::Dict& settings) const;
-    void LoadStopsData(TransportCatalogue& catalogue, const json::Array& requests) const;
-    void LoadStopData(TransportCatalogue& catalogue, const json::Dict& stop) const;
-    void LoadStopsDistances(TransportCatalogue& catalogue, const json::Array& requests) const;
-    void LoadStopDistances(TransportCatalogue& catalogue, const std::string& from, const json::Dict& distances) const;
-    void LoadBusesData(TransportCatalogue& catalogue, const json::Array& requests) const;
-    void LoadBusData(TransportCatalogue& catalogue, const json::Dict& bus) const;
+    std::optional<std::string> CheckBaseRequest(const json::Node& request) const;
+    // Проверяет запросы в нескольких потоках и возвращает первую по порядку ошибку
+    std::optional<std::string> CheckBaseRequests(const std::vector<json::Node>& requests) const;
+    std::optional<std::string> CheckUpdateRequest(const json::Dict& request) const;
+    void LoadBaseRequest(CatalogueLoader& loader, const json::Dict& request);
+    CatalogueUpdate LoadUpdateRequests(const json::Array& requests) const;
+    void LoadStopData(CatalogueData& data, const json::Dict& stop) const;
+    void LoadBusData(CatalogueData& data, const json::Dict& bus) const;
     svg::Point LoadRenderOffset(const json::Array& offset) const;
     svg::Color LoadRenderColor(const json::Node& color) const;
     std::vector<svg::Color> LoadRenderColorPalette(const json::Array& pallete) const;
-    json::Node GetBusJsonData(const request_handler::RequestHandler& handler, const Request& request) const;
-    json::Node GetStopJsonData(const request_handler::RequestHandler& handler, const Request& request) const;
-    json::Node GetMapJsonData(const request_handler::RequestHandler& handler, const Request& request) const;
-    json::Node GetRouteJsonData(const request_handler::RequestHandler& handler, const Request& request) const;
+    geo::Coordinates LoadRoutePoint(const json::Dict& point) const;
+    void WriteBusAnswer(json::Writer& writer, const request_handler::RequestHandler& handler, const Request& request) const;
+    void WriteStopAnswer(json::Writer& writer, const request_handler::RequestHandler& handler, const Request& request) const;
+    void WriteMapAnswer(json::Writer& writer, const request_handler::RequestHandler& handler, const Request& request) const;
+    void WriteRouteAnswer(json::Writer& writer, const request_handler::RequestHandler& handler, const Request& request) const;
+    void WriteNearestStopsAnswer(json::Writer& writer, const request_handler::RequestHandler& handler,
+                                 const Request& request) const;
+    void WriteStopsInBoxAnswer(json::Writer& writer, const request_handler::RequestHandler& handler,
+                               const Request& request) const;
+    void WriteSuggestAnswer(json::Writer& writer, const request_handler::RequestHandler& handler,
+                            const Request& request) const;
+    void WriteMemoryStatsAnswer(json::Writer& writer, const request_handler::RequestHandler& handler,
+                                const Request& request) const;
 };
 
 } // json_reader
@@ -1,21 +1,75 @@
+#include "catalogue_snapshot.h"
 #include "json.h"
 #include "json_reader.h"
 #include "map_renderer.h"
 #include "request_handler.h"
+#include "serialization.h"
 #include "transport_catalogue.h"
 #include "transport_router.h"
 
 #include <iostream>
+#include <memory>
+#include <string_view>
 
-int main() {
+using namespace std::literals;
+
+void PrintUsage(std::ostream& stream = std::cerr) {
+    stream << "Usage: transport_catalogue [make_base|process_requests]\n"sv;
+}
+
+int main(int argc, char* argv[]) {
     using namespace transport_catalogue;
 
-    TransportCatalogue catalogue;
-    json_reader::JsonReader json_reader(std::cin);
-    json_reader.LoadCatalogueData(catalogue);
-    map_renderer::MapRenderer renderer(json_reader.LoadRenderSettings());
-    transport_router::TransportRouter router(catalogue, json_reader.LoadRouterSettings());
-    request_handler::RequestHandler request_handler(catalogue, renderer, router);
-    auto answers_json = json_reader.RenderAnswersJson(request_handler, json_reader.LoadStatRequests());
-    json::Print(answers_json, std::cout);;
+    if (argc > 2) {
+        PrintUsage();
+        return 1;
+    }
+    const std::string_view mode = argc == 2 ? argv[1] : ""sv;
+
+    if (mode.empty()) {
+        // Каталог ссылается на названия во входных данных, поэтому json_reader создаётся раньше
+        json_reader::JsonReader json_reader(std::cin);
+        auto catalogue = std::make_unique<TransportCatalogue>();
+        json_reader.LoadCatalogueData(*catalogue);
+        json_reader.ApplyUpdateRequests(*catalogue);
+        // Запросы обслуживаются из опубликованного снимка: каталог и маршрутизатор в нём уже не меняются
+        SnapshotStore store;
+        store.Publish(store.Build(std::move(catalogue), json_reader.LoadRouterSettings()));
+        const SnapshotStore::Pin snapshot = store.Acquire();
+        map_renderer::MapRenderer renderer(json_reader.LoadRenderSettings());
+        request_handler::RequestHandler request_handler(snapshot->GetCatalogue(), renderer, snapshot->GetRouter());
+        json_reader.WriteAnswersJson(request_handler, json_reader.LoadStatRequests(), std::cout);
+    } else if (mode == "make_base"sv) {
+        // Разбирает base_requests и настройки и сохраняет их в двоичный снимок
+        json_reader::JsonReader json_reader(std::cin);
+        TransportCatalogue catalogue;
+        json_reader.LoadCatalogueData(catalogue);
+        json_reader.ApplyUpdateRequests(catalogue);
+        // Маршрутизатор строится здесь, а не при обработке запросов: его граф и оверлей сохраняются в снимок
+        const transport_router::TransportRouter router(catalogue, json_reader.LoadRouterSettings());
+        serialization::SaveSnapshot(json_reader.LoadSerializationSettings().file, catalogue, router,
+                                    json_reader.LoadRenderSettings());
+    } else if (mode == "process_requests"sv) {
+        // Загружает каталог, маршрутизатор и настройки из снимка и отвечает на stat_requests.
+        // Каталог и маршрутизатор ссылаются на названия в файле снимка, поэтому он создаётся раньше
+        json_reader::JsonReader json_reader(std::cin);
+        serialization::SnapshotFile snapshot_file(json_reader.LoadSerializationSettings().file);
+        auto catalogue = std::make_unique<TransportCatalogue>();
+        snapshot_file.LoadCatalogue(*catalogue);
+        const auto update_report = json_reader.ApplyUpdateRequests(*catalogue);
+        SnapshotStore store;
+        // Сохранённый маршрутизатор подходит, пока изменения не затронули граф
+        if (!update_report || !update_report->route_graph) {
+            store.Publish(store.Build(std::move(catalogue), snapshot_file.LoadRouterState()));
+        } else {
+            store.Publish(store.Build(std::move(catalogue), snapshot_file.GetRouterSettings()));
+        }
+        const SnapshotStore::Pin snapshot = store.Acquire();
+        map_renderer::MapRenderer renderer(snapshot_file.GetRenderSettings());
+        request_handler::RequestHandler request_handler(snapshot->GetCatalogue(), renderer, snapshot->GetRouter());
+        json_reader.WriteAnswersJson(request_handler, json_reader.LoadStatRequests(), std::cout);
+    } else {
+        PrintUsage();
+        return 1;
+    }
 }
\ No newline at end of file
@@ -12,18 +12,21 @@ bool IsZero(double value) {
 MapRenderer::MapRenderer(const RenderSettings& settings) : settings_(settings) {
 }
 
-svg::Document MapRenderer::RenderMap(const Buses& buses, const Stops& stops) const {
+svg::Document MapRenderer::RenderMap(const TransportCatalogue& catalogue) const {
     svg::Document document;
+    const geo::CoordinatesView stop_coordinates = catalogue.GetStopCoordinates();
     std::vector<geo::Coordinates> coords;
-    for (const auto& stop : stops) {
-        coords.push_back(stop.second->coordinates);
+    for (StopId stop_id = 0; stop_id < stop_coordinates.size; ++stop_id) {
+        if (!catalogue.GetStopInfo(stop_id).empty()) {
+            coords.push_back(stop_coordinates[stop_id]);
+        }
     }
     const SphereProjector projector(coords.begin(), coords.end(), settings_.width, settings_.height, settings_.padding);
 
-    RenderBusLines(buses, document, projector);
-    RenderBusNames(buses, document, projector);
-    RenderStopCircles(stops, document, projector);
-    RenderStopNames(stops, document, projector);
+    RenderBusLines(catalogue, document, projector);
+    RenderBusNames(catalogue, document, projector);
+    RenderStopCircles(catalogue, document, projector);
+    RenderStopNames(catalogue, document, projector);
 
     return document;
 }
@@ -36,14 +39,29 @@ RenderSettings MapRenderer::GetSettings() const {
     return settings_;
 }
 
-void MapRenderer::RenderBusLines(const Buses& buses, svg::Document& document, const SphereProjector& projector) const {
+memory_stats::MemoryStats MapRenderer::GetMemoryStats() const {
+    memory_stats::Usage palette = memory_stats::GetVectorUsage(settings_.color_palette);
+    for (const svg::Color& color : settings_.color_palette) {
+        if (const auto* name = std::get_if<std::string>(&color)) {
+            palette.bytes += memory_stats::GetStringUsage(*name).bytes;
+        }
+    }
+    memory_stats::MemoryStats stats;
+    stats.Add("color_palette", palette);
+    return stats;
+}
+
+void MapRenderer::RenderBusLines(const TransportCatalogue& catalogue, svg::Document& document,
+                                 const SphereProjector& projector) const {
+    const geo::CoordinatesView stop_coordinates = catalogue.GetStopCoordinates();
     int color_index = 0;
     
-    for (const auto& [_, bus] : buses) {
-        if (!bus->stops.empty()) {
+    for (BusId bus_id : catalogue.GetBusIdsSortedByName()) {
+        const Bus& bus = catalogue.GetBus(bus_id);
+        if (!bus.stops.empty()) {
             svg::Polyline bus_line;
-            for (auto stop : bus->stops) {
-                bus_line.AddPoint(projector(stop->coordinates));
+            for (StopId stop_id : bus.GetRoute()) {
+                bus_line.AddPoint(projector(stop_coordinates[stop_id]));
             }
             bus_line.SetStrokeColor(settings_.color_palette[color_index])
                     .SetFillColor(svg::NoneColor)
@@ -60,7 +78,8 @@ void MapRenderer::RenderBusLines(const Buses& buses, svg::Document& document, co
     }
 }
 
-void MapRenderer::RenderBusNames(const Buses& buses, svg::Document& document, const SphereProjector& projector) const {
+void MapRenderer::RenderBusNames(const TransportCatalogue& catalogue, svg::Document& document,
+                                 const SphereProjector& projector) const {
     svg::Text text, underlayer;
     text.SetOffset(settings_.bus_label_offset)
         .SetFontSize(settings_.bus_label_font_size)
@@ -75,21 +94,22 @@ void MapRenderer::RenderBusNames(const Buses& buses, svg::Document& document, co
 
     int color_index = 0;
     
-    for (const auto& [busname, bus] : buses) {
-        if (!bus->stops.empty()) {
-            svg::Point coord_start = projector(bus->stops[0]->coordinates);
+    for (BusId bus_id : catalogue.GetBusIdsSortedByName()) {
+        const Bus& bus = catalogue.GetBus(bus_id);
+        if (!bus.stops.empty()) {
+            svg::Point coord_start = projector(catalogue.GetStop(bus.stops[0]).coordinates);
             document.Add(underlayer.SetPosition(coord_start)
-                                   .SetData(std::string(busname)));
+                                   .SetData(std::string(bus.name)));
             document.Add(text.SetPosition(coord_start)
-                             .SetData(std::string(busname))
+                             .SetData(std::string(bus.name))
                              .SetFillColor(settings_.color_palette[color_index]));
-            if (!bus->is_round) {
-                svg::Point coord_end = projector(bus->stops[(bus->stops.size() - 1) / 2]->coordinates);
+            if (!bus.is_round) {
+                svg::Point coord_end = projector(catalogue.GetStop(bus.stops[bus.stops.size() - 1]).coordinates);
                 if (coord_end != coord_start) {
                     document.Add(underlayer.SetPosition(coord_end)
-                                       .SetData(std::string(busname)));
+                                       .SetData(std::string(bus.name)));
                     document.Add(text.SetPosition(coord_end)
-                                .SetData(std::string(busname))
+                                .SetData(std::string(bus.name))
                                 .SetFillColor(settings_.color_palette[color_index]));
                 }
             }
@@ -102,16 +122,21 @@ void MapRenderer::RenderBusNames(const Buses& buses, svg::Document& document, co
     }
 }
 
-void MapRenderer::RenderStopCircles(const Stops& stops, svg::Document& document, const SphereProjector& projector) const {
+void MapRenderer::RenderStopCircles(const TransportCatalogue& catalogue, svg::Document& document,
+                                    const SphereProjector& projector) const {
     svg::Circle stop_circle;
     stop_circle.SetRadius(settings_.stop_radius)
                .SetFillColor("white"s);
-    for (const auto& [_, stop] : stops) {
-        document.Add(stop_circle.SetCenter(projector(stop->coordinates)));
+    const geo::CoordinatesView stop_coordinates = catalogue.GetStopCoordinates();
+    for (StopId stop_id : catalogue.GetStopIdsSortedByName()) {
+        if (!catalogue.GetStopInfo(stop_id).empty()) {
+            document.Add(stop_circle.SetCenter(projector(stop_coordinates[stop_id])));
+        }
     }
 }
 
-void MapRenderer::RenderStopNames(const Stops& stops, svg::Document& document, const SphereProjector& projector) const {
+void MapRenderer::RenderStopNames(const TransportCatalogue& catalogue, svg::Document& document,
+                                  const SphereProjector& projector) const {
     svg::Text text, underlayer;
     text.SetOffset(settings_.stop_label_offset)
         .SetFontSize(settings_.stop_label_font_size)
@@ -124,12 +149,16 @@ void MapRenderer::RenderStopNames(const Stops& stops, svg::Document& document, c
               .SetStrokeLineJoin(svg::StrokeLineJoin::ROUND);
     text.SetFillColor("black"s);
 
-    for (const auto& [stopname, stop] : stops) {
-        svg::Point coord = projector(stop->coordinates);
+    for (StopId stop_id : catalogue.GetStopIdsSortedByName()) {
+        if (catalogue.GetStopInfo(stop_id).empty()) {
+            continue;
+        }
+        const Stop stop = catalogue.GetStop(stop_id);
+        svg::Point coord = projector(stop.coordinates);
         document.Add(underlayer.SetPosition(coord)
-                               .SetData(std::string(stopname)));
+                               .SetData(std::string(stop.name)));
         document.Add(text.SetPosition(coord)
-                         .SetData(std::string(stopname)));
+                         .SetData(std::string(stop.name)));
     }
 }
 
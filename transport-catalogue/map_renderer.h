@@ -9,6 +9,7 @@
 #include "domain.h"
 #include "geo.h"
 #include "svg.h"
+#include "transport_catalogue.h"
 
 namespace transport_catalogue {
 namespace map_renderer {
@@ -100,21 +101,20 @@ private:
 
 class MapRenderer {
 public:
-    using Buses = std::map<std::string_view, Bus*>;
-    using Stops = std::map<std::string_view, Stop*>;
-
     MapRenderer(const RenderSettings& settings);
-    svg::Document RenderMap(const Buses& buses, const Stops& stops) const;
+    // Отрисовывает маршруты и остановки с маршрутами в порядке названий (каталог должен быть заморожен)
+    svg::Document RenderMap(const TransportCatalogue& catalogue) const;
     void SetSettings(const RenderSettings& settings);
     RenderSettings GetSettings() const;
+    memory_stats::MemoryStats GetMemoryStats() const;
 
 private:
     RenderSettings settings_;
 
-    void RenderBusLines(const Buses& buses, svg::Document& document, const SphereProjector& projector) const;
-    void RenderBusNames(const Buses& buses, svg::Document& document, const SphereProjector& projector) const;
-    void RenderStopCircles(const Stops& stops, svg::Document& document, const SphereProjector& projector) const;
-    void RenderStopNames(const Stops& stops, svg::Document& document, const SphereProjector& projector) const;
+    void RenderBusLines(const TransportCatalogue& catalogue, svg::Document& document, const SphereProjector& projector) const;
+    void RenderBusNames(const TransportCatalogue& catalogue, svg::Document& document, const SphereProjector& projector) const;
+    void RenderStopCircles(const TransportCatalogue& catalogue, svg::Document& document, const SphereProjector& projector) const;
+    void RenderStopNames(const TransportCatalogue& catalogue, svg::Document& document, const SphereProjector& projector) const;
 };
 
 } // map_renderer
@@ -0,0 +1,33 @@
+#include "memory_stats.h"
+
+namespace memory_stats {
+
+Usage& Usage::operator+=(const Usage& other) {
+    elements += other.elements;
+    bytes += other.bytes;
+    return *this;
+}
+
+void MemoryStats::Add(std::string name, Usage usage) {
+    entries_.push_back({std::move(name), usage});
+}
+
+void MemoryStats::Add(const std::string& prefix, const MemoryStats& other) {
+    for (const Entry& entry : other.entries_) {
+        entries_.push_back({prefix + "." + entry.name, entry.usage});
+    }
+}
+
+const std::vector<Entry>& MemoryStats::GetEntries() const {
+    return entries_;
+}
+
+size_t MemoryStats::GetTotalBytes() const {
+    size_t result = 0;
+    for (const Entry& entry : entries_) {
+        result += entry.usage.bytes;
+    }
+    return result;
+}
+
+} // memory_stats
\ No newline at end of file
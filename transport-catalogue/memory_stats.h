@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace memory_stats {
+
+// Память структуры: число элементов и байты в куче с учётом зарезервированной ёмкости
+struct Usage {
+    size_t elements = 0;
+    size_t bytes = 0;
+
+    Usage& operator+=(const Usage& other);
+};
+
+struct Entry {
+    std::string name;
+    Usage usage;
+};
+
+class MemoryStats {
+public:
+    void Add(std::string name, Usage usage);
+    // Добавляет записи other с именами вида "prefix.name"
+    void Add(const std::string& prefix, const MemoryStats& other);
+    const std::vector<Entry>& GetEntries() const;
+    size_t GetTotalBytes() const;
+
+private:
+    std::vector<Entry> entries_;
+};
+
+// Размер блока, который выделит malloc: служебное слово и выравнивание по 16 байт
+constexpr size_t GetAllocationSize(size_t size) {
+    return size == 0 ? 0 : (size + sizeof(size_t) + 15) / 16 * 16;
+}
+
+template <typename T>
+Usage GetVectorUsage(const std::vector<T>& vector) {
+    return {vector.size(), GetAllocationSize(vector.capacity() * sizeof(T))};
+}
+
+inline Usage GetVectorUsage(const std::vector<bool>& vector) {
+    return {vector.size(), GetAllocationSize((vector.capacity() + 7) / 8)};
+}
+
+// Узел хранит указатель на следующий узел, элемент и закешированный хеш; таблица — массив указателей
+template <typename Key, typename Value, typename Hash, typename Equal>
+Usage GetHashMapUsage(const std::unordered_map<Key, Value, Hash, Equal>& map) {
+    const size_t node_size = GetAllocationSize(sizeof(void*) + sizeof(std::pair<const Key, Value>) + sizeof(size_t));
+    return {map.size(), GetAllocationSize(map.bucket_count() * sizeof(void*)) + map.size() * node_size};
+}
+
+// Узел красно-чёрного дерева: цвет, три указателя и элемент
+template <typename Key, typename Value, typename Compare>
+Usage GetMapUsage(const std::map<Key, Value, Compare>& map) {
+    const size_t node_size = GetAllocationSize(4 * sizeof(void*) + sizeof(std::pair<const Key, Value>));
+    return {map.size(), map.size() * node_size};
+}
+
+// Короткие строки хранятся внутри объекта и не занимают кучу
+inline Usage GetStringUsage(const std::string& str) {
+    const char* object = reinterpret_cast<const char*>(&str);
+    const bool is_local = str.data() >= object && str.data() < object + sizeof(str);
+    return {str.size(), is_local ? 0 : GetAllocationSize(str.capacity() + 1)};
+}
+
+} // memory_stats
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "name_search.h"
+
+#include <algorithm>
+
+namespace transport_catalogue {
+
+namespace {
+
+// Читает символ UTF-8; некорректный байт считается отдельным символом
+char32_t DecodeSymbol(std::string_view text, size_t& pos) {
+    const auto lead = static_cast<unsigned char>(text[pos]);
+    const size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+    if (length <= 1 || pos + length > text.size()) {
+        ++pos;
+        return lead;
+    }
+    char32_t symbol = lead & (0x7F >> length);
+    for (size_t i = 1; i < length; ++i) {
+        const auto next = static_cast<unsigned char>(text[pos + i]);
+        if ((next >> 6) != 0x2) {
+            ++pos;
+            return lead;
+        }
+        symbol = (symbol << 6) | (next & 0x3F);
+    }
+    pos += length;
+    return symbol;
+}
+
+} // namespace
+
+PrefixMatcher::PrefixMatcher(std::string_view query, int max_errors)
+    : max_errors_(max_errors) {
+    for (size_t pos = 0; pos < query.size();) {
+        query_.push_back(DecodeSymbol(query, pos));
+    }
+    // Пустое начало названия: расстояние до первых j символов запроса равно j
+    for (size_t j = 0; j <= query_.size(); ++j) {
+        rows_.push_back(static_cast<int>(j));
+    }
+    offsets_.push_back(0);
+    row_mins_.push_back(0);
+    best_errors_.push_back(static_cast<int>(query_.size()));
+}
+
+std::optional<int> PrefixMatcher::Match(std::string_view name) {
+    const size_t common = std::mismatch(name.begin(), name.begin() + std::min(name.size(), last_name_.size()),
+                                        last_name_.begin()).first - name.begin();
+    last_name_ = name;
+    if (pruned_length_ != 0 && pruned_length_ <= common) {
+        return std::nullopt;
+    }
+    pruned_length_ = 0;
+
+    // Строки для символов, целиком лежащих в общем начале, остаются верными
+    const size_t depth = std::upper_bound(offsets_.begin(), offsets_.end(), common) - offsets_.begin();
+    offsets_.resize(depth);
+    row_mins_.resize(depth);
+    best_errors_.resize(depth);
+    rows_.resize(depth * (query_.size() + 1));
+
+    while (true) {
+        // Минимум строки не убывает с её номером, поэтому дальше расстояние не уменьшится
+        if (row_mins_.back() > max_errors_) {
+            pruned_length_ = offsets_.back();
+            return std::nullopt;
+        }
+        const int best = best_errors_.back();
+        if (row_mins_.back() >= best) {
+            return best;
+        }
+        size_t pos = offsets_.back();
+        if (pos == name.size()) {
+            return best <= max_errors_ ? std::optional<int>{best} : std::nullopt;
+        }
+        const char32_t symbol = DecodeSymbol(name, pos);
+        PushRow(symbol, pos);
+    }
+}
+
+size_t PrefixMatcher::GetPrunedLength() const {
+    return pruned_length_;
+}
+
+void PrefixMatcher::SetMaxErrors(int max_errors) {
+    // Прежнее отсечение остаётся верным и при меньшем пороге
+    max_errors_ = max_errors;
+}
+
+void PrefixMatcher::PushRow(char32_t symbol, size_t offset) {
+    const size_t width = query_.size() + 1;
+    const size_t previous = rows_.size() - width;
+    rows_.push_back(rows_[previous] + 1);
+    int row_min = rows_.back();
+    for (size_t j = 1; j < width; ++j) {
+        const int substitution = rows_[previous + j - 1] + (query_[j - 1] == symbol ? 0 : 1);
+        const int deletion = rows_[previous + j] + 1;
+        const int insertion = rows_.back() + 1;
+        rows_.push_back(std::min({substitution, deletion, insertion}));
+        row_min = std::min(row_min, rows_.back());
+    }
+    offsets_.push_back(offset);
+    row_mins_.push_back(row_min);
+    best_errors_.push_back(std::min(best_errors_.back(), rows_.back()));
+}
+
+} // transport_catalogue
\ No newline at end of file
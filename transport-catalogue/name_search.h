@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace transport_catalogue {
+
+enum class NameKind {STOP, BUS};
+
+// Название остановки или автобуса, начало которого отличается от запроса на errors правок
+struct NameMatch {
+    NameKind kind;
+    uint32_t id;
+    std::string_view name;
+    int errors;
+};
+
+/*
+ * Нечёткий поиск по началу названия: наименьшее расстояние Левенштейна (по символам UTF-8)
+ * между запросом и каким-либо началом названия.
+ * Названия подаются в порядке сортировки, и строки динамики для общего с предыдущим названием
+ * начала не пересчитываются — обход отсортированного массива равносилен обходу бора.
+ * Если минимум строки превысил допустимое число правок, любое продолжение этого начала тоже
+ * не подходит: его длину возвращает GetPrunedLength, и вызывающий код пропускает такие названия
+ */
+class PrefixMatcher {
+public:
+    PrefixMatcher(std::string_view query, int max_errors);
+    // Число правок, превращающих query в начало name, или nullopt, если их больше max_errors
+    std::optional<int> Match(std::string_view name);
+    // Длина начала последнего названия, продолжения которого не подходят, или 0
+    size_t GetPrunedLength() const;
+    // Уменьшает допустимое число правок для следующих названий
+    void SetMaxErrors(int max_errors);
+
+private:
+    std::vector<char32_t> query_;
+    int max_errors_;
+    // Строки динамики подряд: строка d — расстояния от первых d символов названия до начал запроса
+    std::vector<int> rows_;
+    // Для каждой строки: смещение в байтах, минимум строки и лучшее расстояние до запроса целиком
+    std::vector<size_t> offsets_;
+    std::vector<int> row_mins_;
+    std::vector<int> best_errors_;
+    std::string_view last_name_;
+    size_t pruned_length_ = 0;
+
+    void PushRow(char32_t symbol, size_t offset);
+};
+
+} // transport_catalogue
\ No newline at end of file
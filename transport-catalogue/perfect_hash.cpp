@@ -0,0 +1,148 @@
+#include "perfect_hash.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace transport_catalogue {
+
+namespace {
+
+// Перемешивание splitmix64: из одного хеша строки получаются независимые значения
+uint64_t Mix(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+// Число пар смещений, перебираемых для корзины, прежде чем сменить зерно
+constexpr uint32_t MAX_D0 = 64;
+constexpr uint32_t MAX_SEED_ATTEMPTS = 32;
+
+} // namespace
+
+void PerfectHash::Build(const std::vector<std::string_view>& keys, const std::vector<uint32_t>& values) {
+    for (uint32_t attempt = 0; attempt < MAX_SEED_ATTEMPTS; ++attempt) {
+        seed_ = Mix(attempt);
+        if (TryBuild(keys, values)) {
+            return;
+        }
+    }
+    throw std::logic_error("Cannot build a perfect hash function: the keys are not distinct");
+}
+
+std::optional<uint32_t> PerfectHash::Find(std::string_view key) const {
+    if (values_.empty()) {
+        return std::nullopt;
+    }
+    const Hashes hashes = ComputeHashes(key);
+    const auto [d0, d1] = displacements_[hashes.bucket % displacements_.size()];
+    return values_[GetSlot(hashes, d0, d1, values_.size())];
+}
+
+size_t PerfectHash::GetSize() const {
+    return values_.size();
+}
+
+PerfectHash::State PerfectHash::GetState() const {
+    return {seed_, displacements_, values_};
+}
+
+void PerfectHash::SetState(State state) {
+    if (!state.values.empty() && state.displacements.empty()) {
+        throw std::invalid_argument("A perfect hash function without buckets");
+    }
+    seed_ = state.seed;
+    displacements_ = std::move(state.displacements);
+    values_ = std::move(state.values);
+}
+
+memory_stats::Usage PerfectHash::GetMemoryUsage() const {
+    return {values_.size(), memory_stats::GetVectorUsage(displacements_).bytes + memory_stats::GetVectorUsage(values_).bytes};
+}
+
+PerfectHash::Hashes PerfectHash::ComputeHashes(std::string_view key) const {
+    const uint64_t hash = std::hash<std::string_view>{}(key) ^ seed_;
+    return {Mix(hash), Mix(hash + 1), Mix(hash + 2)};
+}
+
+size_t PerfectHash::GetSlot(const Hashes& hashes, uint32_t d0, uint32_t d1, size_t size) {
+    // Слагаемые приводятся по модулю до сложения: сумма полных 64-битных значений переполнялась бы,
+    // и ячейка одиночного ключа, подобранная как (h1 mod n + d1) mod n, при поиске не совпадала бы
+    return (hashes.h1 % size + d0 * hashes.h2 % size + d1) % size;
+}
+
+bool PerfectHash::TryBuild(const std::vector<std::string_view>& keys, const std::vector<uint32_t>& values) {
+    const size_t size = keys.size();
+    const size_t bucket_count = std::max<size_t>(1, size / BUCKET_SIZE);
+    displacements_.assign(bucket_count, {0, 0});
+    values_.assign(size, 0);
+    if (size == 0) {
+        return true;
+    }
+
+    std::vector<Hashes> hashes(size);
+    std::vector<std::vector<uint32_t>> buckets(bucket_count);
+    for (uint32_t i = 0; i < size; ++i) {
+        hashes[i] = ComputeHashes(keys[i]);
+        buckets[hashes[i].bucket % bucket_count].push_back(i);
+    }
+    std::vector<uint32_t> order(bucket_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&buckets](uint32_t lhs, uint32_t rhs) {
+        return buckets[lhs].size() > buckets[rhs].size();
+    });
+
+    std::vector<bool> occupied(size, false);
+    std::vector<size_t> slots;
+    size_t free_slot = 0;
+    for (uint32_t bucket_index : order) {
+        const auto& bucket = buckets[bucket_index];
+        if (bucket.empty()) {
+            break;
+        }
+        if (bucket.size() == 1) {
+            // Одиночный ключ ставится в первую свободную ячейку подбором d1
+            while (occupied[free_slot]) {
+                ++free_slot;
+            }
+            const uint32_t key = bucket.front();
+            const size_t h1 = GetSlot(hashes[key], 0, 0, size);
+            displacements_[bucket_index] = {0, static_cast<uint32_t>((free_slot + size - h1) % size)};
+            occupied[free_slot] = true;
+            values_[free_slot] = values[key];
+            continue;
+        }
+
+        bool placed = false;
+        for (uint32_t d0 = 1; d0 <= MAX_D0 && !placed; ++d0) {
+            for (uint32_t d1 = 0; d1 < size && !placed; ++d1) {
+                slots.clear();
+                for (uint32_t key : bucket) {
+                    const size_t slot = GetSlot(hashes[key], d0, d1, size);
+                    if (occupied[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+                        break;
+                    }
+                    slots.push_back(slot);
+                }
+                if (slots.size() == bucket.size()) {
+                    displacements_[bucket_index] = {d0, d1};
+                    for (size_t i = 0; i < bucket.size(); ++i) {
+                        occupied[slots[i]] = true;
+                        values_[slots[i]] = values[bucket[i]];
+                    }
+                    placed = true;
+                }
+            }
+        }
+        if (!placed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // transport_catalogue
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "memory_stats.h"
+
+namespace transport_catalogue {
+
+/*
+ * Минимальная совершенная хеш-функция над неизменным набором строк (схема CHD).
+ * Ключи раскладываются по корзинам в среднем по BUCKET_SIZE штук; для каждой корзины, начиная
+ * с самых больших, подбирается пара смещений (d0, d1), при которой все её ключи попадают
+ * в свободные ячейки (h1 + d0 * h2 + d1) mod n. Поиск — одно вычисление хеша, чтение смещений
+ * корзины и значения ячейки; совпадение ключа проверяет вызывающий код
+ */
+class PerfectHash {
+public:
+    // Построенная функция целиком: сохраняется в снимок и восстанавливается без подбора смещений
+    struct State {
+        uint64_t seed = 0;
+        std::vector<std::pair<uint32_t, uint32_t>> displacements;
+        std::vector<uint32_t> values;
+    };
+
+    // Строит функцию для различных ключей; ключу keys[i] соответствует значение values[i]
+    void Build(const std::vector<std::string_view>& keys, const std::vector<uint32_t>& values);
+    // Значение единственного ключа, который мог совпасть с key, или nullopt для пустого набора
+    std::optional<uint32_t> Find(std::string_view key) const;
+    size_t GetSize() const;
+    State GetState() const;
+    // Выбрасывает std::invalid_argument, если у непустого набора значений нет корзин
+    void SetState(State state);
+    memory_stats::Usage GetMemoryUsage() const;
+
+private:
+    static constexpr size_t BUCKET_SIZE = 3;
+
+    struct Hashes {
+        uint64_t bucket;
+        uint64_t h1;
+        uint64_t h2;
+    };
+
+    uint64_t seed_ = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> displacements_;
+    std::vector<uint32_t> values_;
+
+    Hashes ComputeHashes(std::string_view key) const;
+    static size_t GetSlot(const Hashes& hashes, uint32_t d0, uint32_t d1, size_t size);
+    bool TryBuild(const std::vector<std::string_view>& keys, const std::vector<uint32_t>& values);
+};
+
+} // transport_catalogue
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <iterator>
 #include <string_view>
 #include <unordered_map>
@@ -22,6 +23,15 @@ public:
     It end() const {
         return end_;
     }
+    size_t size() const {
+        return std::distance(begin_, end_);
+    }
+    bool empty() const {
+        return begin_ == end_;
+    }
+    decltype(auto) operator[](size_t index) const {
+        return begin_[index];
+    }
 
 private:
     It begin_;
@@ -14,27 +14,49 @@ std::optional<BusInfo> RequestHandler::GetBusInfo(std::string_view bus_name) con
     return catalogue_.GetBusInfo(bus_name);
 }
 
-std::optional<std::set<std::string_view>> RequestHandler::GetStopInfo(std::string_view stop_name) const {
+std::optional<TransportCatalogue::BusIdRange> RequestHandler::GetStopInfo(std::string_view stop_name) const {
     return catalogue_.GetStopInfo(stop_name);
 }
 
+std::string_view RequestHandler::GetBusName(BusId bus_id) const {
+    return catalogue_.GetBus(bus_id).name;
+}
+
+std::string_view RequestHandler::GetStopName(StopId stop_id) const {
+    return catalogue_.GetStop(stop_id).name;
+}
+
+std::vector<NearbyStop> RequestHandler::GetNearestStops(geo::Coordinates coordinates, size_t count) const {
+    return catalogue_.NearestStops(coordinates, count);
+}
+
+std::vector<StopId> RequestHandler::GetStopsInBox(const geo::BoundingBox& box) const {
+    return catalogue_.StopsInBox(box);
+}
+
+std::vector<NameMatch> RequestHandler::GetNameSuggestions(std::string_view prefix, size_t count, int max_errors) const {
+    return catalogue_.SuggestNames(prefix, count, max_errors);
+}
+
+memory_stats::MemoryStats RequestHandler::GetMemoryStats() const {
+    memory_stats::MemoryStats stats;
+    stats.Add("catalogue", catalogue_.GetMemoryStats());
+    stats.Add("router", router_.GetMemoryStats());
+    stats.Add("renderer", renderer_.GetMemoryStats());
+    return stats;
+}
+
 svg::Document RequestHandler::RenderMap() const {
-    std::map<std::string_view, Stop*> stop_list;
-    for (const auto& [name, ptr] : catalogue_.GetStopList()) {
-        if (!catalogue_.GetStopInfo(name).value().empty()) {
-            stop_list[name] = ptr;
-        }
-    }
-    std::map<std::string_view, Bus*> bus_list;
-    for (const auto& [name, ptr] : catalogue_.GetBusList()) {
-        bus_list[name] = ptr;
-    }
-    return renderer_.RenderMap(bus_list, stop_list);
+    return renderer_.RenderMap(catalogue_);
 }
 
 std::optional<transport_router::RouteInfo> RequestHandler::GetRouteInfo(std::string_view from, std::string_view to) const {
     return router_.GetRouteInfo(from, to);
 }
 
+std::optional<transport_router::RouteInfo> RequestHandler::GetRouteInfo(geo::Coordinates from, geo::Coordinates to) const {
+    return router_.GetRouteInfo(from, to);
+}
+
 } // request_handler
 } // transport_catalogue
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace transport_catalogue {
 namespace request_handler {
@@ -21,11 +22,25 @@ public:
     // Возвращает информацию о маршруте (запрос Bus)
     std::optional<BusInfo> GetBusInfo(std::string_view bus_name) const;
     // Возвращает маршруты, проходящие через остановку (запрос Stop)
-    std::optional<std::set<std::string_view>> GetStopInfo(std::string_view stop_name) const;
+    std::optional<TransportCatalogue::BusIdRange> GetStopInfo(std::string_view stop_name) const;
+    // Возвращает название автобуса по идентификатору
+    std::string_view GetBusName(BusId bus_id) const;
+    // Возвращает название остановки по идентификатору
+    std::string_view GetStopName(StopId stop_id) const;
+    // Возвращает ближайшие к точке остановки (запрос NearestStops)
+    std::vector<NearbyStop> GetNearestStops(geo::Coordinates coordinates, size_t count) const;
+    // Возвращает остановки внутри прямоугольника (запрос StopsInBox)
+    std::vector<StopId> GetStopsInBox(const geo::BoundingBox& box) const;
+    // Возвращает остановки и автобусы, названия которых начинаются с prefix с учётом опечаток (запрос Suggest)
+    std::vector<NameMatch> GetNameSuggestions(std::string_view prefix, size_t count, int max_errors) const;
+    // Возвращает память, занимаемую каталогом, маршрутизатором и отрисовщиком
+    memory_stats::MemoryStats GetMemoryStats() const;
     // Возвращает svg-документ карты
     svg::Document RenderMap() const;
     // Возвращает описание маршрута между двумя остановками
     std::optional<transport_router::RouteInfo> GetRouteInfo(std::string_view from, std::string_view to) const;
+    // Возвращает описание маршрута между двумя точками с пешими участками до остановок
+    std::optional<transport_router::RouteInfo> GetRouteInfo(geo::Coordinates from, geo::Coordinates to) const;
 
 private:
     const TransportCatalogue& catalogue_;
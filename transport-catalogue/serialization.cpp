@@ -0,0 +1,790 @@
+#include "serialization.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TRANSPORT_CATALOGUE_USE_MMAP
+#endif
+
+namespace transport_catalogue {
+namespace serialization {
+
+using namespace std::literals;
+
+namespace {
+
+constexpr char MAGIC[8] = {'T', 'C', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr uint32_t FORMAT_VERSION = 4;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr size_t ALIGNMENT = 8;
+
+enum Section : size_t {
+    STRINGS,
+    STOPS,
+    // Ячейки таблицы расстояний как есть
+    DISTANCES,
+    BUSES,
+    BUS_STOPS,
+    // Цвет подложки, затем палитра
+    COLORS,
+    SETTINGS,
+    // Производные индексы замороженного каталога: при загрузке они не строятся заново
+    CATALOGUE,
+    STOP_HASH_DISPLACEMENTS,
+    STOP_HASH_VALUES,
+    BUS_HASH_DISPLACEMENTS,
+    BUS_HASH_VALUES,
+    BUS_INFOS,
+    ROUTE_ROADS,
+    ROUTE_GEOS,
+    SORTED_STOPS,
+    SORTED_BUSES,
+    STOP_BUS_OFFSETS,
+    STOP_BUS_IDS,
+    STOP_INDEX_IDS,
+    STOP_INDEX_POINTS,
+    STOP_INDEX_AXES,
+    STOP_INDEX_BOXES,
+    // Граф и оверлей маршрутизатора: при загрузке не выполняется предобработка
+    ROUTER_EDGES,
+    ROUTER_VERTEX_CELLS,
+    ROUTER_CLIQUES,
+    SECTION_COUNT
+};
+
+struct SectionRecord {
+    uint64_t offset;
+    uint64_t count;
+};
+
+struct Header {
+    char magic[8];
+    uint32_t format_version;
+    uint32_t byte_order;
+    uint64_t size;
+    uint64_t checksum;
+    SectionRecord sections[SECTION_COUNT];
+};
+
+// Флаги записей остановок и автобусов
+constexpr uint32_t REMOVED = 1;
+constexpr uint32_t ROUND = 2;
+// Для всех отрезков маршрута известны расстояния по дорогам
+constexpr uint32_t ROAD_LENGTHS = 4;
+
+// Строки хранятся смещением и длиной в секции STRINGS
+struct StopRecord {
+    uint64_t name_offset;
+    uint32_t name_size;
+    uint32_t flags;
+    double lat;
+    double lng;
+};
+
+struct DistanceSlotRecord {
+    uint64_t key;
+    int32_t forward;
+    int32_t backward;
+};
+
+// Остановки автобуса — stops_count идентификаторов секции BUS_STOPS начиная с индекса stops_offset.
+// Префиксные суммы длин полного маршрута занимают в секциях ROUTE_ROADS и ROUTE_GEOS
+// по одному элементу на остановку полного маршрута начиная с индекса lengths_offset
+struct BusRecord {
+    uint64_t name_offset;
+    uint32_t name_size;
+    uint32_t flags;
+    uint64_t stops_offset;
+    uint64_t stops_count;
+    uint64_t lengths_offset;
+};
+
+struct BusInfoRecord {
+    int32_t stops_count;
+    int32_t unique_stops_count;
+    int32_t route_length;
+    // 0, если статистики нет
+    uint32_t has_info;
+    double curvature;
+};
+
+struct CatalogueRecord {
+    uint64_t stop_hash_seed;
+    uint64_t bus_hash_seed;
+};
+
+struct DisplacementRecord {
+    uint32_t d0;
+    uint32_t d1;
+};
+
+struct PointRecord {
+    double x;
+    double y;
+    double z;
+};
+
+struct BoxRecord {
+    double min_lat;
+    double min_lng;
+    double max_lat;
+    double max_lng;
+};
+
+enum class EdgeType : uint32_t {WAIT, BUS};
+
+// Ребро графа маршрутизатора; span_count равен 0 у ребра ожидания
+struct EdgeRecord {
+    uint32_t from;
+    uint32_t to;
+    double weight;
+    uint64_t name_offset;
+    uint32_t name_size;
+    EdgeType type;
+    int32_t span_count;
+    int32_t distance;
+};
+
+struct CliqueRecord {
+    double weight;
+    // 0, если пути между входом и выходом ячейки нет
+    uint64_t has_weight;
+};
+
+enum class ColorType : uint8_t {NONE, NAME, RGB, RGBA};
+
+struct ColorRecord {
+    uint64_t name_offset;
+    uint32_t name_size;
+    ColorType type;
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+    double opacity;
+};
+
+struct SettingsRecord {
+    double width;
+    double height;
+    double padding;
+    double line_width;
+    double stop_radius;
+    int32_t bus_label_font_size;
+    int32_t stop_label_font_size;
+    double bus_label_offset_x;
+    double bus_label_offset_y;
+    double stop_label_offset_x;
+    double stop_label_offset_y;
+    double underlayer_width;
+    double bus_wait_time;
+    double bus_velocity;
+    double walk_velocity;
+    double max_walk_distance;
+};
+
+// FNV-1a по 64-битным словам: один проход по файлу без побайтового цикла
+uint64_t ComputeChecksum(const std::byte* data, size_t size) {
+    const uint64_t prime = 1099511628211ull;
+    uint64_t hash = 14695981039346656037ull;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ static_cast<uint64_t>(data[i])) * prime;
+    }
+    return hash;
+}
+
+class SnapshotBuilder {
+public:
+    SnapshotBuilder() {
+        std::memcpy(header_.magic, MAGIC, sizeof(MAGIC));
+    }
+
+    std::pair<uint64_t, uint32_t> AddString(std::string_view str) {
+        const uint64_t offset = strings_.size();
+        strings_.append(str);
+        return {offset, static_cast<uint32_t>(str.size())};
+    }
+
+    // Название каталога записывается один раз: рёбра маршрутизатора ссылаются на ту же строку
+    // в памяти каталога и получают то же смещение
+    std::pair<uint64_t, uint32_t> AddName(std::string_view name) {
+        auto [it, inserted] = name_offsets_.try_emplace(name.data());
+        if (inserted || name.size() != it->second.second) {
+            it->second = AddString(name);
+        }
+        return it->second;
+    }
+
+    ColorRecord MakeColor(const svg::Color& color) {
+        ColorRecord record{};
+        if (std::holds_alternative<std::string>(color)) {
+            record.type = ColorType::NAME;
+            std::tie(record.name_offset, record.name_size) = AddString(std::get<std::string>(color));
+        } else if (std::holds_alternative<svg::Rgb>(color)) {
+            const auto& rgb = std::get<svg::Rgb>(color);
+            record = {0, 0, ColorType::RGB, rgb.red, rgb.green, rgb.blue, 1.0};
+        } else if (std::holds_alternative<svg::Rgba>(color)) {
+            const auto& rgba = std::get<svg::Rgba>(color);
+            record = {0, 0, ColorType::RGBA, rgba.red, rgba.green, rgba.blue, rgba.opacity};
+        }
+        return record;
+    }
+
+    template <typename Record>
+    void AddSection(Section section, const std::vector<Record>& records) {
+        AddSection(section, records.data(), records.size(), sizeof(Record));
+    }
+
+    std::string Build() {
+        AddSection(STRINGS, strings_.data(), strings_.size(), 1);
+        header_.size = buffer_.size();
+        header_.checksum = ComputeChecksum(reinterpret_cast<const std::byte*>(buffer_.data()) + sizeof(Header),
+                                           buffer_.size() - sizeof(Header));
+        std::memcpy(buffer_.data(), &header_, sizeof(Header));
+        return std::move(buffer_);
+    }
+
+private:
+    Header header_{{}, FORMAT_VERSION, BYTE_ORDER_MARK, 0, 0, {}};
+    std::string buffer_ = std::string(sizeof(Header), '\0');
+    std::string strings_;
+    std::unordered_map<const char*, std::pair<uint64_t, uint32_t>> name_offsets_;
+
+    void AddSection(Section section, const void* data, size_t count, size_t record_size) {
+        buffer_.resize((buffer_.size() + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT, '\0');
+        header_.sections[section] = {buffer_.size(), count};
+        buffer_.append(static_cast<const char*>(data), count * record_size);
+    }
+};
+
+} // namespace
+
+void SaveSnapshot(const std::string& path, const TransportCatalogue& catalogue,
+                  const transport_router::TransportRouter& router,
+                  const map_renderer::RenderSettings& render_settings) {
+    SnapshotBuilder builder;
+    const TransportCatalogue::State state = catalogue.GetState();
+
+    std::vector<StopRecord> stops;
+    stops.reserve(state.stop_names.size());
+    for (StopId stop_id = 0; stop_id < state.stop_names.size(); ++stop_id) {
+        const auto [name_offset, name_size] = builder.AddName(state.stop_names[stop_id]);
+        const uint32_t flags = state.removed_stops[stop_id] ? REMOVED : 0;
+        stops.push_back({name_offset, name_size, flags, state.stop_lats[stop_id], state.stop_lngs[stop_id]});
+    }
+    builder.AddSection(STOPS, stops);
+
+    std::vector<DistanceSlotRecord> distances;
+    distances.reserve(state.distances.slots.size());
+    for (const DistanceTable::Slot& slot : state.distances.slots) {
+        distances.push_back({slot.key, slot.forward, slot.backward});
+    }
+    builder.AddSection(DISTANCES, distances);
+
+    std::vector<BusRecord> buses;
+    std::vector<StopId> bus_stops;
+    std::vector<int32_t> route_roads;
+    std::vector<double> route_geos;
+    std::vector<BusInfoRecord> bus_infos;
+    buses.reserve(state.buses.size());
+    bus_infos.reserve(state.buses.size());
+    for (BusId bus_id = 0; bus_id < state.buses.size(); ++bus_id) {
+        const Bus& bus = state.buses[bus_id];
+        const TransportCatalogue::RouteLengths& lengths = state.route_lengths[bus_id];
+        const auto [name_offset, name_size] = builder.AddName(bus.name);
+        const uint32_t flags = (state.removed_buses[bus_id] ? REMOVED : 0) | (bus.is_round ? ROUND : 0)
+                             | (lengths.road.empty() ? 0 : ROAD_LENGTHS);
+        buses.push_back({name_offset, name_size, flags, bus_stops.size(), bus.stops.size(), route_geos.size()});
+        bus_stops.insert(bus_stops.end(), bus.stops.begin(), bus.stops.end());
+        // Без расстояний по дорогам место в ROUTE_ROADS заполняется нулями, чтобы смещения совпадали
+        route_roads.insert(route_roads.end(), lengths.road.begin(), lengths.road.end());
+        route_roads.resize(route_roads.size() + lengths.geo.size() - lengths.road.size(), 0);
+        route_geos.insert(route_geos.end(), lengths.geo.begin(), lengths.geo.end());
+        const auto& info = state.bus_infos[bus_id];
+        bus_infos.push_back(info ? BusInfoRecord{info->stops_count, info->unique_stops_count, info->route_length, 1,
+                                                 info->curvature}
+                                 : BusInfoRecord{0, 0, 0, 0, 0.0});
+    }
+    builder.AddSection(BUSES, buses);
+    builder.AddSection(BUS_STOPS, bus_stops);
+    builder.AddSection(BUS_INFOS, bus_infos);
+    builder.AddSection(ROUTE_ROADS, route_roads);
+    builder.AddSection(ROUTE_GEOS, route_geos);
+
+    builder.AddSection(CATALOGUE, std::vector<CatalogueRecord>{{state.stop_name_hash.seed, state.bus_name_hash.seed}});
+    auto add_hash = [&builder](Section displacements_section, Section values_section, const PerfectHash::State& hash) {
+        std::vector<DisplacementRecord> displacements;
+        displacements.reserve(hash.displacements.size());
+        for (const auto& [d0, d1] : hash.displacements) {
+            displacements.push_back({d0, d1});
+        }
+        builder.AddSection(displacements_section, displacements);
+        builder.AddSection(values_section, hash.values);
+    };
+    add_hash(STOP_HASH_DISPLACEMENTS, STOP_HASH_VALUES, state.stop_name_hash);
+    add_hash(BUS_HASH_DISPLACEMENTS, BUS_HASH_VALUES, state.bus_name_hash);
+    builder.AddSection(SORTED_STOPS, state.sorted_stop_ids);
+    builder.AddSection(SORTED_BUSES, state.sorted_bus_ids);
+    builder.AddSection(STOP_BUS_OFFSETS, std::vector<uint64_t>(state.stop_bus_offsets.begin(), state.stop_bus_offsets.end()));
+    builder.AddSection(STOP_BUS_IDS, state.stop_bus_ids);
+
+    const SpatialIndex::State& stop_index = state.stop_index;
+    std::vector<PointRecord> points;
+    points.reserve(stop_index.points.size());
+    for (const SpatialIndex::Point& point : stop_index.points) {
+        points.push_back({point.x, point.y, point.z});
+    }
+    std::vector<BoxRecord> boxes;
+    boxes.reserve(stop_index.boxes.size());
+    for (const geo::BoundingBox& box : stop_index.boxes) {
+        boxes.push_back({box.min.lat, box.min.lng, box.max.lat, box.max.lng});
+    }
+    builder.AddSection(STOP_INDEX_IDS, stop_index.ids);
+    builder.AddSection(STOP_INDEX_POINTS, points);
+    builder.AddSection(STOP_INDEX_AXES, stop_index.axes);
+    builder.AddSection(STOP_INDEX_BOXES, boxes);
+
+    const transport_router::TransportRouter::State router_state = router.GetState();
+    std::vector<EdgeRecord> edges;
+    edges.reserve(router_state.edges.size());
+    for (size_t id = 0; id < router_state.edges.size(); ++id) {
+        const auto& edge = router_state.edges[id];
+        const auto& info = router_state.edge_infos[id];
+        const auto [name_offset, name_size] = builder.AddName(info.name);
+        const bool is_bus = info.type == transport_router::EdgeType::BUS;
+        edges.push_back({static_cast<uint32_t>(edge.from), static_cast<uint32_t>(edge.to), edge.weight, name_offset,
+                         name_size, is_bus ? EdgeType::BUS : EdgeType::WAIT, info.span_count.value_or(0),
+                         router_state.edge_distances[id]});
+    }
+    builder.AddSection(ROUTER_EDGES, edges);
+    std::vector<uint32_t> vertex_cells;
+    for (const auto& level : router_state.overlay.vertex_cells) {
+        vertex_cells.insert(vertex_cells.end(), level.begin(), level.end());
+    }
+    builder.AddSection(ROUTER_VERTEX_CELLS, vertex_cells);
+    std::vector<CliqueRecord> cliques;
+    cliques.reserve(router_state.overlay.cliques.size());
+    for (const auto& weight : router_state.overlay.cliques) {
+        cliques.push_back({weight.value_or(0.0), weight.has_value()});
+    }
+    builder.AddSection(ROUTER_CLIQUES, cliques);
+
+    std::vector<ColorRecord> colors;
+    colors.reserve(render_settings.color_palette.size() + 1);
+    colors.push_back(builder.MakeColor(render_settings.underlayer_color));
+    for (const svg::Color& color : render_settings.color_palette) {
+        colors.push_back(builder.MakeColor(color));
+    }
+    builder.AddSection(COLORS, colors);
+
+    const transport_router::RouterSettings& router_settings = router_state.settings;
+    const SettingsRecord settings{
+        render_settings.width, render_settings.height, render_settings.padding,
+        render_settings.line_width, render_settings.stop_radius,
+        render_settings.bus_label_font_size, render_settings.stop_label_font_size,
+        render_settings.bus_label_offset.x, render_settings.bus_label_offset.y,
+        render_settings.stop_label_offset.x, render_settings.stop_label_offset.y,
+        render_settings.underlayer_width,
+        router_settings.bus_wait_time, router_settings.bus_velocity,
+        router_settings.walk_velocity, router_settings.max_walk_distance};
+    builder.AddSection(SETTINGS, std::vector<SettingsRecord>{settings});
+
+    const std::string data = builder.Build();
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!out) {
+        throw std::runtime_error("Cannot write snapshot file "s + path);
+    }
+}
+
+SnapshotFile::SnapshotFile(const std::string& path) {
+#ifdef TRANSPORT_CATALOGUE_USE_MMAP
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open snapshot file "s + path);
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot open snapshot file "s + path);
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+    void* data = size_ > 0 ? mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Cannot map snapshot file "s + path);
+    }
+    data_ = static_cast<const std::byte*>(data);
+    is_mapped_ = true;
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open snapshot file "s + path);
+    }
+    const std::string content{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    size_ = content.size();
+    buffer_.resize((size_ + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    std::memcpy(buffer_.data(), content.data(), size_);
+    data_ = reinterpret_cast<const std::byte*>(buffer_.data());
+#endif
+
+    try {
+        CheckData();
+    } catch (...) {
+        Unmap();
+        throw;
+    }
+}
+
+SnapshotFile::~SnapshotFile() {
+    Unmap();
+}
+
+size_t SnapshotFile::GetStopCount() const {
+    return GetSectionCount(STOPS);
+}
+
+Stop SnapshotFile::GetStop(StopId stop_id) const {
+    const StopRecord& record = GetSection<StopRecord>(STOPS)[stop_id];
+    return {GetString(record.name_offset, record.name_size), {record.lat, record.lng}};
+}
+
+size_t SnapshotFile::GetBusCount() const {
+    return GetSectionCount(BUSES);
+}
+
+Bus SnapshotFile::GetBus(BusId bus_id) const {
+    const BusRecord& record = GetSection<BusRecord>(BUSES)[bus_id];
+    const StopId* stops = GetSection<StopId>(BUS_STOPS) + record.stops_offset;
+    return {GetString(record.name_offset, record.name_size), {stops, stops + record.stops_count},
+            (record.flags & ROUND) != 0};
+}
+
+bool SnapshotFile::IsStopRemoved(StopId stop_id) const {
+    return (GetSection<StopRecord>(STOPS)[stop_id].flags & REMOVED) != 0;
+}
+
+bool SnapshotFile::IsBusRemoved(BusId bus_id) const {
+    return (GetSection<BusRecord>(BUSES)[bus_id].flags & REMOVED) != 0;
+}
+
+map_renderer::RenderSettings SnapshotFile::GetRenderSettings() const {
+    const SettingsRecord& record = *GetSection<SettingsRecord>(SETTINGS);
+    map_renderer::RenderSettings result;
+    result.width = record.width;
+    result.height = record.height;
+    result.padding = record.padding;
+    result.line_width = record.line_width;
+    result.stop_radius = record.stop_radius;
+    result.bus_label_font_size = record.bus_label_font_size;
+    result.bus_label_offset = {record.bus_label_offset_x, record.bus_label_offset_y};
+    result.stop_label_font_size = record.stop_label_font_size;
+    result.stop_label_offset = {record.stop_label_offset_x, record.stop_label_offset_y};
+    result.underlayer_color = GetColor(0);
+    result.underlayer_width = record.underlayer_width;
+    for (size_t i = 1; i < GetSectionCount(COLORS); ++i) {
+        result.color_palette.push_back(GetColor(i));
+    }
+    return result;
+}
+
+transport_router::RouterSettings SnapshotFile::GetRouterSettings() const {
+    const SettingsRecord& record = *GetSection<SettingsRecord>(SETTINGS);
+    return {record.bus_wait_time, record.bus_velocity, record.walk_velocity, record.max_walk_distance};
+}
+
+void SnapshotFile::LoadCatalogue(TransportCatalogue& catalogue) const {
+    // Массивы копируются из отображения целиком, индексы не строятся заново
+    auto copy_section = [this](size_t section, auto& target) {
+        using Value = typename std::decay_t<decltype(target)>::value_type;
+        const Value* records = GetSection<Value>(section);
+        target.assign(records, records + GetSectionCount(section));
+    };
+
+    TransportCatalogue::State state;
+    const size_t stop_count = GetStopCount();
+    const StopRecord* stops = GetSection<StopRecord>(STOPS);
+    state.stop_names.reserve(stop_count);
+    state.stop_lats.reserve(stop_count);
+    state.stop_lngs.reserve(stop_count);
+    state.removed_stops.reserve(stop_count);
+    for (size_t i = 0; i < stop_count; ++i) {
+        state.stop_names.push_back(GetString(stops[i].name_offset, stops[i].name_size));
+        state.stop_lats.push_back(stops[i].lat);
+        state.stop_lngs.push_back(stops[i].lng);
+        state.removed_stops.push_back((stops[i].flags & REMOVED) != 0);
+    }
+
+    const DistanceSlotRecord* distances = GetSection<DistanceSlotRecord>(DISTANCES);
+    state.distances.slots.resize(GetSectionCount(DISTANCES));
+    for (size_t i = 0; i < state.distances.slots.size(); ++i) {
+        state.distances.slots[i] = {distances[i].key, distances[i].forward, distances[i].backward};
+    }
+
+    const size_t bus_count = GetBusCount();
+    const BusRecord* buses = GetSection<BusRecord>(BUSES);
+    const BusInfoRecord* bus_infos = GetSection<BusInfoRecord>(BUS_INFOS);
+    const int32_t* route_roads = GetSection<int32_t>(ROUTE_ROADS);
+    const double* route_geos = GetSection<double>(ROUTE_GEOS);
+    state.buses.reserve(bus_count);
+    state.removed_buses.reserve(bus_count);
+    state.bus_infos.reserve(bus_count);
+    state.route_lengths.resize(bus_count);
+    for (BusId bus_id = 0; bus_id < bus_count; ++bus_id) {
+        const BusRecord& record = buses[bus_id];
+        state.buses.push_back(GetBus(bus_id));
+        state.removed_buses.push_back((record.flags & REMOVED) != 0);
+        const BusInfoRecord& info = bus_infos[bus_id];
+        state.bus_infos.push_back(info.has_info ? std::optional<BusInfo>({info.stops_count, info.unique_stops_count,
+                                                                          info.route_length, info.curvature})
+                                                : std::nullopt);
+        const size_t route_size = state.buses.back().GetRoute().size();
+        TransportCatalogue::RouteLengths& lengths = state.route_lengths[bus_id];
+        lengths.geo.assign(route_geos + record.lengths_offset, route_geos + record.lengths_offset + route_size);
+        if (record.flags & ROAD_LENGTHS) {
+            lengths.road.assign(route_roads + record.lengths_offset, route_roads + record.lengths_offset + route_size);
+        }
+    }
+
+    auto load_hash = [this, &copy_section](Section displacements_section, Section values_section, uint64_t seed) {
+        PerfectHash::State hash;
+        hash.seed = seed;
+        const DisplacementRecord* displacements = GetSection<DisplacementRecord>(displacements_section);
+        hash.displacements.resize(GetSectionCount(displacements_section));
+        for (size_t i = 0; i < hash.displacements.size(); ++i) {
+            hash.displacements[i] = {displacements[i].d0, displacements[i].d1};
+        }
+        copy_section(values_section, hash.values);
+        return hash;
+    };
+    const CatalogueRecord& catalogue_record = *GetSection<CatalogueRecord>(CATALOGUE);
+    state.stop_name_hash = load_hash(STOP_HASH_DISPLACEMENTS, STOP_HASH_VALUES, catalogue_record.stop_hash_seed);
+    state.bus_name_hash = load_hash(BUS_HASH_DISPLACEMENTS, BUS_HASH_VALUES, catalogue_record.bus_hash_seed);
+    copy_section(SORTED_STOPS, state.sorted_stop_ids);
+    copy_section(SORTED_BUSES, state.sorted_bus_ids);
+    const uint64_t* stop_bus_offsets = GetSection<uint64_t>(STOP_BUS_OFFSETS);
+    state.stop_bus_offsets.assign(stop_bus_offsets, stop_bus_offsets + GetSectionCount(STOP_BUS_OFFSETS));
+    copy_section(STOP_BUS_IDS, state.stop_bus_ids);
+
+    SpatialIndex::State& stop_index = state.stop_index;
+    copy_section(STOP_INDEX_IDS, stop_index.ids);
+    copy_section(STOP_INDEX_AXES, stop_index.axes);
+    const PointRecord* points = GetSection<PointRecord>(STOP_INDEX_POINTS);
+    stop_index.points.resize(GetSectionCount(STOP_INDEX_POINTS));
+    for (size_t i = 0; i < stop_index.points.size(); ++i) {
+        stop_index.points[i] = {points[i].x, points[i].y, points[i].z};
+    }
+    const BoxRecord* boxes = GetSection<BoxRecord>(STOP_INDEX_BOXES);
+    stop_index.boxes.resize(GetSectionCount(STOP_INDEX_BOXES));
+    for (size_t i = 0; i < stop_index.boxes.size(); ++i) {
+        stop_index.boxes[i] = {{boxes[i].min_lat, boxes[i].min_lng}, {boxes[i].max_lat, boxes[i].max_lng}};
+    }
+
+    try {
+        catalogue.Restore(std::move(state));
+    } catch (const std::invalid_argument&) {
+        throw std::runtime_error("The snapshot file is corrupted"s);
+    }
+}
+
+transport_router::TransportRouter::State SnapshotFile::LoadRouterState() const {
+    transport_router::TransportRouter::State state;
+    state.settings = GetRouterSettings();
+
+    const size_t edge_count = GetSectionCount(ROUTER_EDGES);
+    const EdgeRecord* edges = GetSection<EdgeRecord>(ROUTER_EDGES);
+    state.edges.reserve(edge_count);
+    state.edge_infos.reserve(edge_count);
+    state.edge_distances.reserve(edge_count);
+    for (size_t i = 0; i < edge_count; ++i) {
+        const EdgeRecord& edge = edges[i];
+        const std::string_view name = GetString(edge.name_offset, edge.name_size);
+        state.edges.push_back({edge.from, edge.to, edge.weight});
+        if (edge.type == EdgeType::BUS) {
+            state.edge_infos.push_back({transport_router::EdgeType::BUS, name, edge.span_count, edge.weight});
+        } else {
+            state.edge_infos.push_back({transport_router::EdgeType::WAIT, name, std::nullopt, edge.weight});
+        }
+        state.edge_distances.push_back(edge.distance);
+    }
+
+    // Уровни разбиения хранятся подряд, по числу вершин графа в каждом
+    const size_t vertex_count = GetStopCount() * 2;
+    const uint32_t* vertex_cells = GetSection<uint32_t>(ROUTER_VERTEX_CELLS);
+    const size_t level_count = vertex_count == 0 ? 0 : GetSectionCount(ROUTER_VERTEX_CELLS) / vertex_count;
+    for (size_t level = 0; level < level_count; ++level) {
+        state.overlay.vertex_cells.emplace_back(vertex_cells + level * vertex_count,
+                                                vertex_cells + (level + 1) * vertex_count);
+    }
+    const CliqueRecord* cliques = GetSection<CliqueRecord>(ROUTER_CLIQUES);
+    state.overlay.cliques.reserve(GetSectionCount(ROUTER_CLIQUES));
+    for (size_t i = 0; i < GetSectionCount(ROUTER_CLIQUES); ++i) {
+        state.overlay.cliques.push_back(cliques[i].has_weight ? std::optional<double>(cliques[i].weight) : std::nullopt);
+    }
+    return state;
+}
+
+void SnapshotFile::CheckData() const {
+    if (size_ < sizeof(Header)) {
+        throw std::runtime_error("The snapshot file is too small"s);
+    }
+    const Header& header = *reinterpret_cast<const Header*>(data_);
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("The file is not a catalogue snapshot"s);
+    }
+    if (header.format_version != FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported snapshot format version "s + std::to_string(header.format_version));
+    }
+    if (header.byte_order != BYTE_ORDER_MARK) {
+        throw std::runtime_error("The snapshot was written on a platform with another byte order"s);
+    }
+    if (header.size != size_ || header.checksum != ComputeChecksum(data_ + sizeof(Header), size_ - sizeof(Header))) {
+        throw std::runtime_error("The snapshot file is corrupted"s);
+    }
+
+    const size_t record_sizes[SECTION_COUNT] = {
+        1, sizeof(StopRecord), sizeof(DistanceSlotRecord), sizeof(BusRecord), sizeof(StopId), sizeof(ColorRecord),
+        sizeof(SettingsRecord), sizeof(CatalogueRecord), sizeof(DisplacementRecord), sizeof(StopId),
+        sizeof(DisplacementRecord), sizeof(BusId), sizeof(BusInfoRecord), sizeof(int32_t), sizeof(double),
+        sizeof(StopId), sizeof(BusId), sizeof(uint64_t), sizeof(BusId), sizeof(StopId), sizeof(PointRecord),
+        sizeof(uint8_t), sizeof(BoxRecord), sizeof(EdgeRecord), sizeof(uint32_t), sizeof(CliqueRecord)};
+    for (size_t section = 0; section < SECTION_COUNT; ++section) {
+        const auto [offset, count] = header.sections[section];
+        if (offset % ALIGNMENT != 0 || offset < sizeof(Header) || offset > size_
+                || count > (size_ - offset) / record_sizes[section]) {
+            throw std::runtime_error("The snapshot file is corrupted"s);
+        }
+    }
+    if (GetSectionCount(SETTINGS) != 1 || GetSectionCount(COLORS) == 0 || GetSectionCount(CATALOGUE) != 1
+            || GetSectionCount(BUS_INFOS) != GetBusCount() || GetSectionCount(ROUTE_ROADS) != GetSectionCount(ROUTE_GEOS)) {
+        throw std::runtime_error("The snapshot file is corrupted"s);
+    }
+
+    // Ссылки между секциями проверяются один раз, после этого записи читаются без проверок
+    const size_t stop_count = GetStopCount();
+    const size_t string_size = GetSectionCount(STRINGS);
+    auto check_string = [string_size](uint64_t offset, uint32_t size) {
+        if (offset > string_size || size > string_size - offset) {
+            throw std::runtime_error("The snapshot file is corrupted"s);
+        }
+    };
+    const StopRecord* stops = GetSection<StopRecord>(STOPS);
+    for (size_t i = 0; i < stop_count; ++i) {
+        check_string(stops[i].name_offset, stops[i].name_size);
+    }
+    auto check_ids = [this](size_t section, size_t id_count) {
+        const uint32_t* ids = GetSection<uint32_t>(section);
+        for (size_t i = 0; i < GetSectionCount(section); ++i) {
+            if (ids[i] >= id_count) {
+                throw std::runtime_error("The snapshot file is corrupted"s);
+            }
+        }
+    };
+    const DistanceSlotRecord* distances = GetSection<DistanceSlotRecord>(DISTANCES);
+    for (size_t i = 0; i < GetSectionCount(DISTANCES); ++i) {
+        if (distances[i].key != DistanceTable::EMPTY_KEY
+                && ((distances[i].key >> 32) >= stop_count || (distances[i].key & UINT32_MAX) >= stop_count)) {
+            throw std::runtime_error("The snapshot file is corrupted"s);
+        }
+    }
+    const size_t bus_count = GetBusCount();
+    const BusRecord* buses = GetSection<BusRecord>(BUSES);
+    const size_t bus_stop_count = GetSectionCount(BUS_STOPS);
+    const size_t lengths_count = GetSectionCount(ROUTE_GEOS);
+    for (size_t i = 0; i < bus_count; ++i) {
+        const BusRecord& bus = buses[i];
+        check_string(bus.name_offset, bus.name_size);
+        if (bus.stops_offset > bus_stop_count || bus.stops_count > bus_stop_count - bus.stops_offset) {
+            throw std::runtime_error("The snapshot file is corrupted"s);
+        }
+        const size_t route_size = (bus.flags & ROUND) || bus.stops_count == 0 ? bus.stops_count : 2 * bus.stops_count - 1;
+        if (bus.lengths_offset > lengths_count || route_size > lengths_count - bus.lengths_offset) {
+            throw std::runtime_error("The snapshot file is corrupted"s);
+        }
+    }
+    check_ids(BUS_STOPS, stop_count);
+    check_ids(STOP_HASH_VALUES, stop_count);
+    check_ids(BUS_HASH_VALUES, bus_count);
+    check_ids(SORTED_STOPS, stop_count);
+    check_ids(SORTED_BUSES, bus_count);
+    check_ids(STOP_BUS_IDS, bus_count);
+    check_ids(STOP_INDEX_IDS, stop_count);
+
+    // Вершины графа маршрутизатора — по две на остановку; согласованность оверлея с графом
+    // проверяет конструктор маршрутизатора
+    const size_t vertex_count = stop_count * 2;
+    const EdgeRecord* edges = GetSection<EdgeRecord>(ROUTER_EDGES);
+    for (size_t i = 0; i < GetSectionCount(ROUTER_EDGES); ++i) {
+        const EdgeRecord& edge = edges[i];
+        check_string(edge.name_offset, edge.name_size);
+        if (edge.from >= vertex_count || edge.to >= vertex_count || edge.type > EdgeType::BUS
+                || (edge.type == EdgeType::BUS && edge.span_count < 1)) {
+            throw std::runtime_error("The snapshot file is corrupted"s);
+        }
+    }
+    const size_t vertex_cell_count = GetSectionCount(ROUTER_VERTEX_CELLS);
+    if (vertex_count == 0 ? vertex_cell_count != 0 : vertex_cell_count % vertex_count != 0) {
+        throw std::runtime_error("The snapshot file is corrupted"s);
+    }
+    const ColorRecord* colors = GetSection<ColorRecord>(COLORS);
+    for (size_t i = 0; i < GetSectionCount(COLORS); ++i) {
+        check_string(colors[i].name_offset, colors[i].name_size);
+        if (colors[i].type > ColorType::RGBA) {
+            throw std::runtime_error("The snapshot file is corrupted"s);
+        }
+    }
+}
+
+void SnapshotFile::Unmap() {
+#ifdef TRANSPORT_CATALOGUE_USE_MMAP
+    if (is_mapped_) {
+        munmap(const_cast<std::byte*>(data_), size_);
+        is_mapped_ = false;
+    }
+#endif
+}
+
+template <typename Record>
+const Record* SnapshotFile::GetSection(size_t section) const {
+    return reinterpret_cast<const Record*>(data_ + reinterpret_cast<const Header*>(data_)->sections[section].offset);
+}
+
+size_t SnapshotFile::GetSectionCount(size_t section) const {
+    return reinterpret_cast<const Header*>(data_)->sections[section].count;
+}
+
+std::string_view SnapshotFile::GetString(uint64_t offset, uint32_t size) const {
+    return {reinterpret_cast<const char*>(GetSection<char>(STRINGS)) + offset, size};
+}
+
+svg::Color SnapshotFile::GetColor(size_t index) const {
+    const ColorRecord& record = GetSection<ColorRecord>(COLORS)[index];
+    switch (record.type) {
+        case ColorType::NAME:
+            return std::string(GetString(record.name_offset, record.name_size));
+        case ColorType::RGB:
+            return svg::Rgb(record.red, record.green, record.blue);
+        case ColorType::RGBA:
+            return svg::Rgba(record.red, record.green, record.blue, record.opacity);
+        default:
+            return std::monostate{};
+    }
+}
+
+} // serialization
+} // transport_catalogue
\ No newline at end of file
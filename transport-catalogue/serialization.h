@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "domain.h"
+#include "map_renderer.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+namespace transport_catalogue {
+namespace serialization {
+
+struct SerializationSettings {
+    std::string file;
+};
+
+/*
+ * Двоичный снимок замороженного каталога, построенного маршрутизатора и настроек.
+ * Файл начинается с заголовка, за которым идут секции из записей фиксированного размера,
+ * выровненные по 8 байт; записи ссылаются друг на друга смещениями и индексами, поэтому
+ * отображённый в память файл читается на месте без разбора. Кроме исходных данных в файле лежат
+ * производные индексы каталога (совершенные хеши названий, списки автобусов остановок, k-d дерево,
+ * префиксные суммы длин маршрутов) и граф с оверлеем маршрутизатора: при загрузке они копируются
+ * массивами, а не строятся заново. Оверлей занимает большую часть файла: размер клик квадратичен
+ * по числу граничных вершин ячеек, поэтому на сетях в десятки тысяч остановок чтение маршрутизатора
+ * занимает секунды, а не миллисекунды. Числа хранятся в порядке байт платформы, которая записала файл:
+ * заголовок содержит метку, по которой такой файл отвергается на платформе с другим порядком.
+ * Контрольная сумма покрывает всё содержимое после заголовка
+ */
+void SaveSnapshot(const std::string& path, const TransportCatalogue& catalogue,
+                  const transport_router::TransportRouter& router,
+                  const map_renderer::RenderSettings& render_settings);
+
+// Отображённый в память файл снимка. Конструктор проверяет заголовок и контрольную сумму
+// и выбрасывает std::runtime_error, если файл не открывается или повреждён
+class SnapshotFile {
+public:
+    explicit SnapshotFile(const std::string& path);
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+    ~SnapshotFile();
+
+    size_t GetStopCount() const;
+    // Название остановки указывает в отображённый файл
+    Stop GetStop(StopId stop_id) const;
+    size_t GetBusCount() const;
+    // Название и остановки автобуса указывают в отображённый файл
+    Bus GetBus(BusId bus_id) const;
+    bool IsStopRemoved(StopId stop_id) const;
+    bool IsBusRemoved(BusId bus_id) const;
+    map_renderer::RenderSettings GetRenderSettings() const;
+    transport_router::RouterSettings GetRouterSettings() const;
+    // Восстанавливает в пустом каталоге замороженное состояние снимка без построения индексов.
+    // Названия и последовательности остановок каталога указывают в отображённый файл,
+    // поэтому объект снимка должен жить дольше каталога
+    void LoadCatalogue(TransportCatalogue& catalogue) const;
+    // Сохранённый маршрутизатор для каталога, загруженного LoadCatalogue. Названия рёбер указывают
+    // в отображённый файл; согласованность оверлея с графом проверяет конструктор TransportRouter
+    transport_router::TransportRouter::State LoadRouterState() const;
+
+private:
+    const std::byte* data_ = nullptr;
+    size_t size_ = 0;
+    // Память, если отображение файла недоступно; слова гарантируют выравнивание записей
+    std::vector<uint64_t> buffer_;
+    bool is_mapped_ = false;
+
+    void CheckData() const;
+    void Unmap();
+
+    template <typename Record>
+    const Record* GetSection(size_t section) const;
+    size_t GetSectionCount(size_t section) const;
+    std::string_view GetString(uint64_t offset, uint32_t size) const;
+    svg::Color GetColor(size_t index) const;
+};
+
+} // serialization
+} // transport_catalogue
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace transport_catalogue {
+
+void SpatialIndex::Build(geo::CoordinatesView stops, std::vector<StopId> stop_ids) {
+    std::vector<Point> points(stops.size);
+    for (size_t i = 0; i < stops.size; ++i) {
+        points[i] = ToPoint(stops[i]);
+    }
+    std::vector<StopId> order = std::move(stop_ids);
+    axes_.assign(order.size(), 0);
+    boxes_.resize(order.size());
+    BuildNode(0, order.size(), order, points, stops);
+
+    // Переупорядочиваем данные в порядке дерева, чтобы обход шёл по соседним ячейкам памяти
+    ids_ = std::move(order);
+    points_.resize(ids_.size());
+    for (size_t i = 0; i < ids_.size(); ++i) {
+        points_[i] = points[ids_[i]];
+    }
+}
+
+std::vector<NearbyStop> SpatialIndex::FindNearest(geo::CoordinatesView stops, geo::Coordinates coordinates,
+                                                  size_t count) const {
+    if (count == 0) {
+        return {};
+    }
+    std::vector<Candidate> heap;
+    heap.reserve(std::min(count, ids_.size()));
+    FindNearest(0, ids_.size(), ToPoint(coordinates), count, heap);
+    std::sort_heap(heap.begin(), heap.end());
+
+    std::vector<NearbyStop> result;
+    result.reserve(heap.size());
+    for (const Candidate& candidate : heap) {
+        result.push_back({candidate.id, geo::ComputeDistance(coordinates, stops[candidate.id])});
+    }
+    return result;
+}
+
+std::vector<NearbyStop> SpatialIndex::FindInRadius(geo::PreparedCoordinatesView stops, geo::Coordinates coordinates,
+                                                   double radius) const {
+    static const double earth_radius = 6371000.0;
+    if (radius < 0) {
+        return {};
+    }
+    // Квадрат хорды, стягивающей дугу длиной radius, с небольшим запасом на погрешность;
+    // точная проверка выполняется по расстоянию на сфере
+    const double chord = 2.0 * std::sin(std::min(radius / earth_radius, 3.1415926535) / 2.0) + 1e-9;
+    std::vector<Candidate> candidates;
+    FindInRadius(0, ids_.size(), ToPoint(coordinates), chord * chord, candidates);
+    std::sort(candidates.begin(), candidates.end());
+
+    // Приближённые расстояния считаются пакетом по всем кандидатам; точное расстояние, которое
+    // попадает в ответ, вычисляется только для тех, кто может оказаться внутри круга
+    std::vector<StopId> ids(candidates.size());
+    std::transform(candidates.begin(), candidates.end(), ids.begin(), [](const Candidate& candidate) {
+        return candidate.id;
+    });
+    std::vector<double> approx_distances(ids.size());
+    geo::ComputeDistancesApprox(coordinates, stops, ids.data(), ids.size(), approx_distances.data());
+
+    std::vector<NearbyStop> result;
+    result.reserve(candidates.size());
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (approx_distances[i] > radius + geo::APPROX_DISTANCE_ERROR) {
+            continue;
+        }
+        const double distance = geo::ComputeDistance(coordinates, stops.coordinates[ids[i]]);
+        if (distance <= radius) {
+            result.push_back({ids[i], distance});
+        }
+    }
+    return result;
+}
+
+std::vector<StopId> SpatialIndex::FindInBox(geo::CoordinatesView stops, const geo::BoundingBox& box) const {
+    std::vector<StopId> result;
+    FindInBox(0, ids_.size(), stops, box, result);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+size_t SpatialIndex::GetSize() const {
+    return ids_.size();
+}
+
+SpatialIndex::State SpatialIndex::GetState() const {
+    return {ids_, points_, axes_, boxes_};
+}
+
+void SpatialIndex::SetState(State state) {
+    const size_t size = state.ids.size();
+    if (state.points.size() != size || state.axes.size() != size || state.boxes.size() != size) {
+        throw std::invalid_argument("Invalid spatial index arrays");
+    }
+    ids_ = std::move(state.ids);
+    points_ = std::move(state.points);
+    axes_ = std::move(state.axes);
+    boxes_ = std::move(state.boxes);
+}
+
+memory_stats::Usage SpatialIndex::GetMemoryUsage() const {
+    using memory_stats::GetVectorUsage;
+    return {ids_.size(), GetVectorUsage(ids_).bytes + GetVectorUsage(points_).bytes + GetVectorUsage(axes_).bytes
+                         + GetVectorUsage(boxes_).bytes};
+}
+
+SpatialIndex::Point SpatialIndex::ToPoint(geo::Coordinates coordinates) {
+    static const double dr = 3.1415926535 / 180.;
+    const double lat = coordinates.lat * dr;
+    const double lng = coordinates.lng * dr;
+    return {std::cos(lat) * std::cos(lng), std::cos(lat) * std::sin(lng), std::sin(lat)};
+}
+
+size_t SpatialIndex::GetRoot(size_t begin, size_t end) {
+    return begin + (end - begin) / 2;
+}
+
+void SpatialIndex::BuildNode(size_t begin, size_t end, std::vector<StopId>& order, const std::vector<Point>& points,
+                             geo::CoordinatesView coordinates) {
+    if (begin >= end) {
+        return;
+    }
+
+    // Разбиваем по оси с наибольшим разбросом точек
+    uint8_t axis = 0;
+    double max_spread = -1.0;
+    for (uint8_t candidate = 0; candidate < 3; ++candidate) {
+        const auto [min_it, max_it] = std::minmax_element(order.begin() + begin, order.begin() + end,
+            [&points, candidate](StopId lhs, StopId rhs) { return points[lhs][candidate] < points[rhs][candidate]; });
+        const double spread = points[*max_it][candidate] - points[*min_it][candidate];
+        if (spread > max_spread) {
+            max_spread = spread;
+            axis = candidate;
+        }
+    }
+
+    const size_t mid = GetRoot(begin, end);
+    std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+        [&points, axis](StopId lhs, StopId rhs) { return points[lhs][axis] < points[rhs][axis]; });
+    axes_[mid] = axis;
+    BuildNode(begin, mid, order, points, coordinates);
+    BuildNode(mid + 1, end, order, points, coordinates);
+
+    geo::BoundingBox box{coordinates[order[mid]], coordinates[order[mid]]};
+    auto merge_child = [this, &box](size_t child_begin, size_t child_end) {
+        if (child_begin >= child_end) {
+            return;
+        }
+        const geo::BoundingBox& child = boxes_[GetRoot(child_begin, child_end)];
+        box.min.lat = std::min(box.min.lat, child.min.lat);
+        box.min.lng = std::min(box.min.lng, child.min.lng);
+        box.max.lat = std::max(box.max.lat, child.max.lat);
+        box.max.lng = std::max(box.max.lng, child.max.lng);
+    };
+    merge_child(begin, mid);
+    merge_child(mid + 1, end);
+    boxes_[mid] = box;
+}
+
+void SpatialIndex::FindNearest(size_t begin, size_t end, const Point& point, size_t count,
+                               std::vector<Candidate>& heap) const {
+    if (begin >= end) {
+        return;
+    }
+    const size_t mid = GetRoot(begin, end);
+    const Point& node = points_[mid];
+    const double dx = point.x - node.x;
+    const double dy = point.y - node.y;
+    const double dz = point.z - node.z;
+    const Candidate candidate{dx * dx + dy * dy + dz * dz, ids_[mid]};
+    if (heap.size() < count) {
+        heap.push_back(candidate);
+        std::push_heap(heap.begin(), heap.end());
+    } else if (candidate < heap.front()) {
+        std::pop_heap(heap.begin(), heap.end());
+        heap.back() = candidate;
+        std::push_heap(heap.begin(), heap.end());
+    }
+
+    const uint8_t axis = axes_[mid];
+    const double diff = point[axis] - node[axis];
+    const bool left_first = diff < 0;
+    if (left_first) {
+        FindNearest(begin, mid, point, count, heap);
+    } else {
+        FindNearest(mid + 1, end, point, count, heap);
+    }
+    // Вторая половина может содержать более близкие точки, только если плоскость разбиения ближе худшего кандидата
+    if (heap.size() < count || diff * diff <= heap.front().chord) {
+        if (left_first) {
+            FindNearest(mid + 1, end, point, count, heap);
+        } else {
+            FindNearest(begin, mid, point, count, heap);
+        }
+    }
+}
+
+void SpatialIndex::FindInRadius(size_t begin, size_t end, const Point& point, double max_chord,
+                                std::vector<Candidate>& result) const {
+    if (begin >= end) {
+        return;
+    }
+    const size_t mid = GetRoot(begin, end);
+    const Point& node = points_[mid];
+    const double dx = point.x - node.x;
+    const double dy = point.y - node.y;
+    const double dz = point.z - node.z;
+    const double chord = dx * dx + dy * dy + dz * dz;
+    if (chord <= max_chord) {
+        result.push_back({chord, ids_[mid]});
+    }
+
+    const uint8_t axis = axes_[mid];
+    const double diff = point[axis] - node[axis];
+    if (diff <= 0 || diff * diff <= max_chord) {
+        FindInRadius(begin, mid, point, max_chord, result);
+    }
+    if (diff >= 0 || diff * diff <= max_chord) {
+        FindInRadius(mid + 1, end, point, max_chord, result);
+    }
+}
+
+void SpatialIndex::FindInBox(size_t begin, size_t end, geo::CoordinatesView stops, const geo::BoundingBox& box,
+                             std::vector<StopId>& result) const {
+    if (begin >= end) {
+        return;
+    }
+    const size_t mid = GetRoot(begin, end);
+    if (!box.Intersects(boxes_[mid])) {
+        return;
+    }
+    if (box.Contains(boxes_[mid])) {
+        result.insert(result.end(), ids_.begin() + begin, ids_.begin() + end);
+        return;
+    }
+    if (box.Contains(stops[ids_[mid]])) {
+        result.push_back(ids_[mid]);
+    }
+    FindInBox(begin, mid, stops, box, result);
+    FindInBox(mid + 1, end, stops, box, result);
+}
+
+} // transport_catalogue
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "domain.h"
+#include "geo.h"
+#include "memory_stats.h"
+
+namespace transport_catalogue {
+
+struct NearbyStop {
+    StopId id;
+    double distance;
+};
+
+/*
+ * Статический k-d дерево над остановками.
+ * Точки хранятся как единичные векторы в трёхмерном пространстве: евклидово расстояние
+ * между ними монотонно по расстоянию на сфере, поэтому поиск ближайших точен по всей сфере.
+ * Дерево неявное: узел — полуинтервал массива, его корень — средний элемент.
+ * Для каждого узла хранится охватывающий прямоугольник в широте и долготе для запросов по области
+ */
+class SpatialIndex {
+public:
+    struct Point {
+        double x;
+        double y;
+        double z;
+
+        double operator[](uint8_t axis) const {
+            return axis == 0 ? x : axis == 1 ? y : z;
+        }
+    };
+
+    // Массивы дерева в порядке обхода: сохраняются в снимок и восстанавливаются без построения
+    struct State {
+        std::vector<StopId> ids;
+        std::vector<Point> points;
+        std::vector<uint8_t> axes;
+        std::vector<geo::BoundingBox> boxes;
+    };
+
+    // Строит индекс по остановкам stop_ids; идентификатор остановки — индекс её координат.
+    // Сами координаты индекс не копирует: запросы получают те же stops, что и Build
+    void Build(geo::CoordinatesView stops, std::vector<StopId> stop_ids);
+    // count ближайших к точке остановок в порядке возрастания расстояния (в метрах)
+    std::vector<NearbyStop> FindNearest(geo::CoordinatesView stops, geo::Coordinates coordinates, size_t count) const;
+    // Остановки не дальше radius метров от точки в порядке возрастания расстояния. Кандидаты отсеиваются
+    // пакетным приближённым расстоянием, расстояния в ответе точные
+    std::vector<NearbyStop> FindInRadius(geo::PreparedCoordinatesView stops, geo::Coordinates coordinates,
+                                         double radius) const;
+    // Остановки внутри прямоугольника в порядке возрастания идентификатора
+    std::vector<StopId> FindInBox(geo::CoordinatesView stops, const geo::BoundingBox& box) const;
+    size_t GetSize() const;
+    State GetState() const;
+    // Массивы должны быть построены этим же индексом по тем же координатам.
+    // Выбрасывает std::invalid_argument, если их длины различаются
+    void SetState(State state);
+    memory_stats::Usage GetMemoryUsage() const;
+
+private:
+    struct Candidate {
+        double chord;
+        StopId id;
+
+        bool operator<(const Candidate& other) const {
+            return chord < other.chord || (chord == other.chord && id < other.id);
+        }
+    };
+
+    std::vector<StopId> ids_;
+    std::vector<Point> points_;
+    // Ось разбиения и охватывающий прямоугольник узла, корнем которого является элемент
+    std::vector<uint8_t> axes_;
+    std::vector<geo::BoundingBox> boxes_;
+
+    static Point ToPoint(geo::Coordinates coordinates);
+    static size_t GetRoot(size_t begin, size_t end);
+    void BuildNode(size_t begin, size_t end, std::vector<StopId>& order, const std::vector<Point>& points,
+                   geo::CoordinatesView coordinates);
+    void FindNearest(size_t begin, size_t end, const Point& point, size_t count, std::vector<Candidate>& heap) const;
+    void FindInRadius(size_t begin, size_t end, const Point& point, double max_chord,
+                      std::vector<Candidate>& result) const;
+    void FindInBox(size_t begin, size_t end, geo::CoordinatesView stops, const geo::BoundingBox& box,
+                   std::vector<StopId>& result) const;
+};
+
+} // transport_catalogue
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catalogue_snapshot.h"
+#include "testing.h"
+
+using namespace transport_catalogue;
+
+namespace {
+
+const transport_router::RouterSettings SETTINGS{6.0, 40.0};
+
+std::string MakeStopName(size_t index) {
+    return "Stop " + std::to_string(index);
+}
+
+// Построитель, в котором i-й снимок имеет ровно i остановок
+void AddNextStop(TransportCatalogue& builder) {
+    const size_t index = builder.GetStopCount() + 1;
+    builder.AddStop({MakeStopName(index), {55.0 + index * 1e-3, 37.0}});
+}
+
+// Содержимое снимка соответствует его номеру
+void CheckSnapshot(const CatalogueSnapshot& snapshot) {
+    const TransportCatalogue& catalogue = snapshot.GetCatalogue();
+    CHECK_EQUAL(catalogue.GetStopCount(), snapshot.GetVersion());
+    const auto stop = catalogue.FindStop(MakeStopName(snapshot.GetVersion()));
+    CHECK(stop.has_value());
+    const auto nearest = catalogue.NearestStops(stop->coordinates, 1);
+    CHECK_EQUAL(nearest.size(), 1u);
+    CHECK_EQUAL(catalogue.GetStop(nearest[0].id).name, stop->name);
+}
+
+void TestEmptyStore() {
+    SnapshotStore store;
+    CHECK(!store.Acquire());
+    CHECK(!store.Publish(nullptr));
+}
+
+void TestOlderSnapshotIsRejected() {
+    SnapshotStore store;
+    TransportCatalogue builder;
+    AddNextStop(builder);
+    auto first = store.Build(builder, SETTINGS);
+    AddNextStop(builder);
+    auto second = store.Build(builder, SETTINGS);
+    CHECK(store.Publish(std::move(second)));
+    CHECK(!store.Publish(std::move(first)));
+    CHECK_EQUAL(store.Acquire()->GetVersion(), 2u);
+    CheckSnapshot(*store.Acquire());
+}
+
+void TestAdoptedCatalogue() {
+    SnapshotStore store;
+    auto catalogue = std::make_unique<TransportCatalogue>();
+    AddNextStop(*catalogue);
+    CHECK(store.Publish(store.Build(std::move(catalogue), SETTINGS)));
+    CheckSnapshot(*store.Acquire());
+}
+
+void TestPinOutlivesPublications() {
+    SnapshotStore store;
+    TransportCatalogue builder;
+    AddNextStop(builder);
+    CHECK(store.Publish(store.Build(builder, SETTINGS)));
+    const SnapshotStore::Pin first = store.Acquire();
+    SnapshotStore::Pin second;
+    for (int i = 0; i < 20; ++i) {
+        AddNextStop(builder);
+        CHECK(store.PublishAsync(builder, SETTINGS).get());
+        if (i == 5) {
+            second = store.Acquire();
+        }
+    }
+    CHECK_EQUAL(first->GetVersion(), 1u);
+    CheckSnapshot(*first);
+    CHECK_EQUAL(second->GetVersion(), 7u);
+    CheckSnapshot(*second);
+    CHECK_EQUAL(store.Acquire()->GetVersion(), 21u);
+}
+
+// Читатели работают, пока писатель публикует новые снимки: каждый читатель видит
+// целые снимки с неубывающими номерами, а закреплённый снимок не освобождается под ним
+void TestReadersDuringPublications() {
+    SnapshotStore store;
+    TransportCatalogue builder;
+    AddNextStop(builder);
+    CHECK(store.Publish(store.Build(builder, SETTINGS)));
+
+    const uint64_t last_version = 300;
+    std::atomic<bool> done = false;
+    std::vector<std::thread> readers;
+    std::vector<size_t> read_counts(3);
+    for (size_t reader = 0; reader < read_counts.size(); ++reader) {
+        readers.emplace_back([&store, &done, &read_counts, reader] {
+            uint64_t version = 0;
+            while (!done.load()) {
+                const SnapshotStore::Pin snapshot = store.Acquire();
+                CHECK(snapshot);
+                CHECK(snapshot->GetVersion() >= version);
+                version = snapshot->GetVersion();
+                CheckSnapshot(*snapshot);
+                ++read_counts[reader];
+            }
+        });
+    }
+    for (uint64_t version = 2; version <= last_version; ++version) {
+        AddNextStop(builder);
+        CHECK(store.Publish(store.Build(builder, SETTINGS)));
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    for (size_t count : read_counts) {
+        CHECK(count > 0);
+    }
+    CHECK_EQUAL(store.Acquire()->GetVersion(), last_version);
+}
+
+} // namespace
+
+int main() {
+    RUN_TEST(TestEmptyStore);
+    RUN_TEST(TestOlderSnapshotIsRejected);
+    RUN_TEST(TestAdoptedCatalogue);
+    RUN_TEST(TestPinOutlivesPublications);
+    RUN_TEST(TestReadersDuringPublications);
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "testing.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+using namespace transport_catalogue;
+using namespace std::literals;
+
+namespace {
+
+const transport_router::RouterSettings SETTINGS{6.0, 40.0};
+
+void AddBus(CatalogueData& data, std::string_view name, std::vector<std::string_view> stops, bool is_round) {
+    const size_t begin = data.bus_stops.size();
+    data.bus_stops.insert(data.bus_stops.end(), stops.begin(), stops.end());
+    data.buses.push_back({name, begin, data.bus_stops.size(), is_round});
+}
+
+CatalogueData MakeInitialData() {
+    CatalogueData data;
+    data.stops = {{"A"sv, {55.60, 37.20}}, {"B"sv, {55.61, 37.21}}, {"C"sv, {55.62, 37.22}},
+                  {"D"sv, {55.63, 37.20}}, {"F"sv, {55.64, 37.19}}};
+    data.distances = {{"A"sv, "B"sv, 1000}, {"B"sv, "A"sv, 1100}, {"B"sv, "C"sv, 1500}, {"C"sv, "D"sv, 800},
+                      {"D"sv, "B"sv, 900}};
+    AddBus(data, "1"sv, {"A"sv, "B"sv, "C"sv}, false);
+    AddBus(data, "2"sv, {"B"sv, "C"sv, "D"sv, "B"sv}, true);
+    return data;
+}
+
+// Изменения: перенос остановки, новая остановка и автобус, удаление расстояния, автобуса
+// и неиспользуемой остановки, новый маршрут существующего автобуса
+CatalogueUpdate MakeUpdate() {
+    CatalogueUpdate update;
+    update.data.stops = {{"C"sv, {55.625, 37.23}}, {"E"sv, {55.65, 37.25}}};
+    update.data.distances = {{"D"sv, "E"sv, 500}, {"E"sv, "D"sv, 600}};
+    update.removed_distances = {{"B"sv, "A"sv}};
+    update.removed_buses = {"2"sv};
+    update.removed_stops = {"F"sv};
+    AddBus(update.data, "1"sv, {"A"sv, "B"sv, "C"sv, "D"sv}, false);
+    AddBus(update.data, "4"sv, {"D"sv, "E"sv}, false);
+    return update;
+}
+
+// Каталог после изменений, построенный с нуля
+CatalogueData MakeFinalData() {
+    CatalogueData data;
+    data.stops = {{"A"sv, {55.60, 37.20}}, {"B"sv, {55.61, 37.21}}, {"C"sv, {55.625, 37.23}},
+                  {"D"sv, {55.63, 37.20}}, {"E"sv, {55.65, 37.25}}};
+    data.distances = {{"A"sv, "B"sv, 1000}, {"B"sv, "C"sv, 1500}, {"C"sv, "D"sv, 800}, {"D"sv, "B"sv, 900},
+                      {"D"sv, "E"sv, 500}, {"E"sv, "D"sv, 600}};
+    AddBus(data, "1"sv, {"A"sv, "B"sv, "C"sv, "D"sv}, false);
+    AddBus(data, "4"sv, {"D"sv, "E"sv}, false);
+    return data;
+}
+
+std::vector<std::string_view> GetBusNames(const TransportCatalogue& catalogue, TransportCatalogue::BusIdRange bus_ids) {
+    std::vector<std::string_view> names;
+    for (BusId bus_id : bus_ids) {
+        names.push_back(catalogue.GetBus(bus_id).name);
+    }
+    return names;
+}
+
+std::vector<std::string_view> GetStopNames(const TransportCatalogue& catalogue,
+                                           TransportCatalogue::StopIdRange stop_ids) {
+    std::vector<std::string_view> names;
+    for (StopId stop_id : stop_ids) {
+        names.push_back(catalogue.GetStop(stop_id).name);
+    }
+    return names;
+}
+
+// Каталоги совпадают во всём, что видно по названиям; идентификаторы могут отличаться
+void CheckSameContents(const TransportCatalogue& actual, const TransportCatalogue& expected) {
+    CHECK(GetStopNames(actual, actual.GetStopIdsSortedByName())
+          == GetStopNames(expected, expected.GetStopIdsSortedByName()));
+    CHECK(GetBusNames(actual, actual.GetBusIdsSortedByName())
+          == GetBusNames(expected, expected.GetBusIdsSortedByName()));
+    for (std::string_view bus_name : {"1"sv, "2"sv, "3"sv, "4"sv}) {
+        const auto actual_info = actual.GetBusInfo(bus_name);
+        const auto expected_info = expected.GetBusInfo(bus_name);
+        CHECK_EQUAL(actual_info.has_value(), expected_info.has_value());
+        if (actual_info) {
+            CHECK_EQUAL(actual_info->stops_count, expected_info->stops_count);
+            CHECK_EQUAL(actual_info->unique_stops_count, expected_info->unique_stops_count);
+            CHECK_EQUAL(actual_info->route_length, expected_info->route_length);
+            CHECK_EQUAL(actual_info->curvature, expected_info->curvature);
+        }
+    }
+    for (std::string_view stop_name : {"A"sv, "B"sv, "C"sv, "D"sv, "E"sv, "F"sv}) {
+        const auto actual_buses = actual.GetStopInfo(stop_name);
+        const auto expected_buses = expected.GetStopInfo(stop_name);
+        CHECK_EQUAL(actual_buses.has_value(), expected_buses.has_value());
+        if (actual_buses) {
+            CHECK(GetBusNames(actual, *actual_buses) == GetBusNames(expected, *expected_buses));
+        }
+    }
+    const auto actual_nearest = actual.NearestStops({55.63, 37.24}, 10);
+    const auto expected_nearest = expected.NearestStops({55.63, 37.24}, 10);
+    CHECK_EQUAL(actual_nearest.size(), expected_nearest.size());
+    for (size_t i = 0; i < actual_nearest.size(); ++i) {
+        CHECK_EQUAL(actual.GetStop(actual_nearest[i].id).name, expected.GetStop(expected_nearest[i].id).name);
+        CHECK_EQUAL(actual_nearest[i].distance, expected_nearest[i].distance);
+    }
+
+    const transport_router::TransportRouter actual_router(actual, SETTINGS);
+    const transport_router::TransportRouter expected_router(expected, SETTINGS);
+    for (std::string_view from : {"A"sv, "B"sv, "C"sv, "D"sv, "E"sv}) {
+        for (std::string_view to : {"A"sv, "B"sv, "C"sv, "D"sv, "E"sv}) {
+            const auto actual_route = actual_router.GetRouteInfo(from, to);
+            const auto expected_route = expected_router.GetRouteInfo(from, to);
+            CHECK_EQUAL(actual_route.has_value(), expected_route.has_value());
+            if (actual_route) {
+                CHECK_EQUAL(actual_route->total_time, expected_route->total_time);
+            }
+        }
+    }
+}
+
+void TestUpdateMatchesRebuild() {
+    TransportCatalogue catalogue;
+    catalogue.Update({MakeInitialData(), {}, {}, {}});
+    const BusId first_bus = *catalogue.FindBusId("1"sv);
+    const UpdateReport report = catalogue.Update(MakeUpdate());
+    CHECK(catalogue.IsFrozen());
+    CHECK(report.sorted_stops);
+    CHECK(report.sorted_buses);
+    CHECK(report.stop_buses);
+    CHECK(report.stop_index);
+    CHECK(report.route_graph);
+    CHECK(std::count(report.bus_infos.begin(), report.bus_infos.end(), first_bus) == 1);
+    CHECK(std::is_sorted(report.bus_infos.begin(), report.bus_infos.end()));
+
+    CHECK(!catalogue.FindStop("F"sv));
+    CHECK(catalogue.FindBus("2"sv) == nullptr);
+    // Обратное расстояние удалено: используется прямое
+    CHECK(catalogue.GetDistance(*catalogue.FindStopId("B"sv), *catalogue.FindStopId("A"sv)) == 1000);
+
+    TransportCatalogue rebuilt;
+    rebuilt.Update({MakeFinalData(), {}, {}, {}});
+    CheckSameContents(catalogue, rebuilt);
+}
+
+void TestDistanceChangeTouchesOnlyItsBuses() {
+    TransportCatalogue catalogue;
+    catalogue.Update({MakeInitialData(), {}, {}, {}});
+    catalogue.Update(MakeUpdate());
+
+    CatalogueUpdate update;
+    update.data.distances = {{"E"sv, "D"sv, 700}};
+    const UpdateReport report = catalogue.Update(update);
+    CHECK(report.bus_infos == std::vector<BusId>{*catalogue.FindBusId("4"sv)});
+    CHECK(!report.sorted_stops);
+    CHECK(!report.sorted_buses);
+    CHECK(!report.stop_index);
+    CHECK(report.route_graph);
+    CHECK_EQUAL(catalogue.GetBusInfo("4"sv)->route_length, 1200);
+
+    // Пустой пакет ничего не перестраивает
+    const UpdateReport empty = catalogue.Update({});
+    CHECK(empty.bus_infos.empty());
+    CHECK(!empty.sorted_stops && !empty.sorted_buses && !empty.stop_buses && !empty.stop_index && !empty.route_graph);
+}
+
+void TestStopNameIsReleased() {
+    TransportCatalogue catalogue;
+    catalogue.Update({MakeInitialData(), {}, {}, {}});
+    CatalogueUpdate remove;
+    remove.removed_stops = {"F"sv};
+    catalogue.Update(remove);
+    CatalogueUpdate add;
+    add.data.stops = {{"F"sv, {10.0, 10.0}}};
+    catalogue.Update(add);
+    const auto stop = catalogue.FindStop("F"sv);
+    CHECK(stop.has_value());
+    CHECK(stop->coordinates == geo::Coordinates({10.0, 10.0}));
+    CHECK_EQUAL(catalogue.GetStopCount(), 6u);
+}
+
+void TestInvalidUpdates() {
+    TransportCatalogue catalogue;
+    catalogue.Update({MakeInitialData(), {}, {}, {}});
+
+    CatalogueUpdate unknown_stop;
+    AddBus(unknown_stop.data, "5"sv, {"A"sv, "X"sv}, true);
+    CHECK_THROWS(catalogue.Update(unknown_stop), std::invalid_argument);
+
+    CatalogueUpdate unknown_bus;
+    unknown_bus.removed_buses = {"X"sv};
+    CHECK_THROWS(catalogue.Update(unknown_bus), std::invalid_argument);
+
+    CatalogueUpdate used_stop;
+    used_stop.removed_stops = {"B"sv};
+    CHECK_THROWS(catalogue.Update(used_stop), std::invalid_argument);
+    CHECK(catalogue.FindStop("B"sv).has_value());
+}
+
+} // namespace
+
+int main() {
+    RUN_TEST(TestUpdateMatchesRebuild);
+    RUN_TEST(TestDistanceChangeTouchesOnlyItsBuses);
+    RUN_TEST(TestStopNameIsReleased);
+    RUN_TEST(TestInvalidUpdates);
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+#include "json.h"
+
+/*
+ * Сравнивает два файла ответов: compare_answers expected.out actual.out.
+ * Ответы должны совпадать полностью, кроме ответов на Route: из нескольких маршрутов
+ * с одинаковым временем программа вправе выбрать любой, поэтому у них сравнивается
+ * общее время, а у фактического ответа проверяется, что время участков даёт в сумме общее
+ */
+
+using namespace std::literals;
+
+namespace {
+
+json::Document LoadFile(const char* path) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        throw std::runtime_error("Can't open "s + path);
+    }
+    return json::Load(input);
+}
+
+bool IsNear(double lhs, double rhs, double tolerance) {
+    return std::abs(lhs - rhs) <= tolerance * std::max(1.0, std::abs(lhs));
+}
+
+bool AreRoutesEquivalent(const json::Dict& expected, const json::Dict& actual) {
+    if (expected.at("request_id"sv) != actual.at("request_id"sv)) {
+        return false;
+    }
+    const double total_time = actual.at("total_time"sv).AsDouble();
+    if (!IsNear(expected.at("total_time"sv).AsDouble(), total_time, 1e-6)) {
+        return false;
+    }
+    double items_time = 0.0;
+    for (const auto& item : actual.at("items"sv).AsArray()) {
+        items_time += item.AsMap().at("time"sv).AsDouble();
+    }
+    // Время участков напечатано с округлением до шести значащих цифр
+    return IsNear(total_time, items_time, 1e-5);
+}
+
+bool AreAnswersEquivalent(const json::Node& expected, const json::Node& actual) {
+    if (expected.IsMap() && actual.IsMap() && expected.AsMap().find("total_time"sv) != expected.AsMap().end()
+        && actual.AsMap().find("total_time"sv) != actual.AsMap().end()) {
+        return AreRoutesEquivalent(expected.AsMap(), actual.AsMap());
+    }
+    return expected == actual;
+}
+
+void PrintNode(const json::Node& node) {
+    json::Writer writer(std::cerr);
+    writer.WriteNode(node);
+    writer.Flush();
+    std::cerr << '\n';
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: compare_answers expected.out actual.out\n"sv;
+        return 2;
+    }
+    const json::Document expected = LoadFile(argv[1]);
+    const json::Document actual = LoadFile(argv[2]);
+    const json::Array& expected_answers = expected.GetRoot().AsArray();
+    const json::Array& actual_answers = actual.GetRoot().AsArray();
+    if (expected_answers.size() != actual_answers.size()) {
+        std::cerr << "Expected "sv << expected_answers.size() << " answers, got "sv << actual_answers.size() << '\n';
+        return 1;
+    }
+    for (size_t i = 0; i < expected_answers.size(); ++i) {
+        if (!AreAnswersEquivalent(expected_answers[i], actual_answers[i])) {
+            std::cerr << "Answer "sv << i << " differs\nExpected:\n"sv;
+            PrintNode(expected_answers[i]);
+            std::cerr << "Actual:\n"sv;
+            PrintNode(actual_answers[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include <limits>
+#include <optional>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "crp_router.h"
+#include "testing.h"
+
+using Graph = graph::DirectedWeightedGraph<double>;
+using Router = graph::CrpRouter<double>;
+
+namespace {
+
+// Случайный граф из сгустков: внутри сгустка рёбра частые, между сгустками — редкие.
+// Веса целые, поэтому суммы сравниваются точно
+Graph MakeGraph(std::mt19937& random, size_t vertex_count, size_t cluster_size) {
+    Graph graph(vertex_count);
+    std::uniform_int_distribution<int> weight(0, 20);
+    std::uniform_int_distribution<size_t> any_vertex(0, vertex_count - 1);
+    for (size_t from = 0; from < vertex_count; ++from) {
+        const size_t cluster_begin = from / cluster_size * cluster_size;
+        const size_t cluster_end = std::min(vertex_count, cluster_begin + cluster_size);
+        std::uniform_int_distribution<size_t> cluster_vertex(cluster_begin, cluster_end - 1);
+        for (int i = 0; i < 3; ++i) {
+            graph.AddEdge({from, cluster_vertex(random), static_cast<double>(weight(random))});
+        }
+        if (random() % 4 == 0) {
+            graph.AddEdge({from, any_vertex(random), static_cast<double>(weight(random))});
+        }
+    }
+    return graph;
+}
+
+// Вес кратчайшего пути по Дейкстре с начальными весами вершин sources
+std::vector<std::optional<double>> ComputeDistances(const Graph& graph, const std::vector<Router::Endpoint>& sources) {
+    std::vector<std::optional<double>> distances(graph.GetVertexCount());
+    using Item = std::pair<double, graph::VertexId>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+    for (const auto& source : sources) {
+        if (!distances[source.vertex] || source.weight < *distances[source.vertex]) {
+            distances[source.vertex] = source.weight;
+            queue.push({source.weight, source.vertex});
+        }
+    }
+    while (!queue.empty()) {
+        const auto [distance, vertex] = queue.top();
+        queue.pop();
+        if (*distances[vertex] < distance) {
+            continue;
+        }
+        for (graph::EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+            const auto& edge = graph.GetEdge(edge_id);
+            const double candidate = distance + edge.weight;
+            if (!distances[edge.to] || candidate < *distances[edge.to]) {
+                distances[edge.to] = candidate;
+                queue.push({candidate, edge.to});
+            }
+        }
+    }
+    return distances;
+}
+
+// Рёбра образуют путь от from до to, и сумма их весов равна weight
+void CheckPath(const Graph& graph, graph::VertexId from, graph::VertexId to, const std::vector<graph::EdgeId>& edges,
+               double weight) {
+    graph::VertexId vertex = from;
+    double sum = 0.0;
+    for (graph::EdgeId edge_id : edges) {
+        const auto& edge = graph.GetEdge(edge_id);
+        CHECK_EQUAL(edge.from, vertex);
+        vertex = edge.to;
+        sum += edge.weight;
+    }
+    CHECK_EQUAL(vertex, to);
+    CHECK_EQUAL(sum, weight);
+}
+
+void CheckAllPairs(const Graph& graph, const Router& router) {
+    for (graph::VertexId from = 0; from < graph.GetVertexCount(); ++from) {
+        const auto expected = ComputeDistances(graph, {{from, 0.0}});
+        for (graph::VertexId to = 0; to < graph.GetVertexCount(); ++to) {
+            const auto route = router.BuildRoute(from, to);
+            CHECK_EQUAL(route.has_value(), expected[to].has_value());
+            if (route) {
+                CHECK_EQUAL(route->weight, *expected[to]);
+                CheckPath(graph, from, to, route->edges, route->weight);
+            }
+        }
+    }
+}
+
+void TestMatchesDijkstra() {
+    std::mt19937 random(1);
+    for (const Router::PartitionSettings settings : {Router::PartitionSettings{}, Router::PartitionSettings{4, 2, 3},
+                                                    Router::PartitionSettings{8, 4, 2}, Router::PartitionSettings{1, 2, 4}}) {
+        for (size_t cluster_size : {5, 20, 200}) {
+            const Graph graph = MakeGraph(random, 150, cluster_size);
+            CheckAllPairs(graph, Router(graph, settings));
+        }
+    }
+}
+
+void TestCustomizeAfterWeightChange() {
+    std::mt19937 random(2);
+    Graph graph = MakeGraph(random, 120, 10);
+    Router router(graph, {4, 3, 3});
+    std::uniform_int_distribution<int> weight(0, 50);
+    for (int round = 0; round < 3; ++round) {
+        for (graph::EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+            if (random() % 2 == 0) {
+                graph.SetEdgeWeight(edge_id, weight(random));
+            }
+        }
+        // Разбиение не зависит от весов: достаточно пересчитать клики
+        router.Customize();
+        CheckAllPairs(graph, router);
+    }
+}
+
+void TestSeveralEndpoints() {
+    std::mt19937 random(3);
+    const Graph graph = MakeGraph(random, 200, 15);
+    const Router router(graph, {6, 3, 3});
+    std::uniform_int_distribution<size_t> any_vertex(0, graph.GetVertexCount() - 1);
+    std::uniform_int_distribution<int> weight(0, 30);
+    for (int i = 0; i < 300; ++i) {
+        std::vector<Router::Endpoint> sources, targets;
+        for (size_t j = 1 + random() % 4; j > 0; --j) {
+            sources.push_back({any_vertex(random), static_cast<double>(weight(random))});
+        }
+        for (size_t j = 1 + random() % 4; j > 0; --j) {
+            targets.push_back({any_vertex(random), static_cast<double>(weight(random))});
+        }
+        const auto distances = ComputeDistances(graph, sources);
+        std::optional<double> expected;
+        for (const auto& target : targets) {
+            if (distances[target.vertex] && (!expected || *distances[target.vertex] + target.weight < *expected)) {
+                expected = *distances[target.vertex] + target.weight;
+            }
+        }
+
+        const auto route = router.BuildRoute(sources, targets);
+        CHECK_EQUAL(route.has_value(), expected.has_value());
+        if (route) {
+            CHECK_EQUAL(route->weight, *expected);
+            const auto& source = sources.at(route->source);
+            const auto& target = targets.at(route->target);
+            CheckPath(graph, source.vertex, target.vertex, route->edges, route->weight - source.weight - target.weight);
+        }
+    }
+}
+
+void TestNegativeWeightIsRejected() {
+    Graph graph(2);
+    graph.AddEdge({0, 1, -1.0});
+    CHECK_THROWS(Router(graph), std::domain_error);
+}
+
+} // namespace
+
+int main() {
+    RUN_TEST(TestMatchesDijkstra);
+    RUN_TEST(TestCustomizeAfterWeightChange);
+    RUN_TEST(TestSeveralEndpoints);
+    RUN_TEST(TestNegativeWeightIsRejected);
+}
\ No newline at end of file
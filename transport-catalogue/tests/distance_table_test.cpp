@@ -0,0 +1,137 @@
+#include <map>
+#include <random>
+#include <utility>
+
+#include "distance_table.h"
+#include "testing.h"
+
+using transport_catalogue::DistanceTable;
+using transport_catalogue::StopId;
+
+namespace {
+
+using Reference = std::map<std::pair<StopId, StopId>, int>;
+
+// Ожидаемый ответ Get: прямое расстояние, иначе обратное
+std::optional<int> Get(const Reference& reference, StopId from, StopId to) {
+    if (auto it = reference.find({from, to}); it != reference.end()) {
+        return it->second;
+    }
+    if (auto it = reference.find({to, from}); it != reference.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+// Число неупорядоченных пар, для которых задано хотя бы одно направление
+size_t CountPairs(const Reference& reference) {
+    size_t count = 0;
+    for (const auto& [stops, distance] : reference) {
+        const auto [from, to] = stops;
+        if (from <= to || reference.count({to, from}) == 0) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+void CheckContents(const DistanceTable& table, const Reference& reference, StopId stop_count) {
+    CHECK_EQUAL(table.GetSize(), CountPairs(reference));
+    for (StopId from = 0; from < stop_count; ++from) {
+        for (StopId to = 0; to < stop_count; ++to) {
+            CHECK(table.Get(from, to) == Get(reference, from, to));
+        }
+    }
+    Reference enumerated;
+    table.ForEach([&enumerated](StopId from, StopId to, int distance) {
+        CHECK(enumerated.emplace(std::make_pair(from, to), distance).second);
+    });
+    CHECK(enumerated == reference);
+}
+
+void TestEmpty() {
+    const DistanceTable table;
+    CHECK(!table.Get(0, 1));
+    CHECK_EQUAL(table.GetSize(), 0u);
+    DistanceTable erased;
+    CHECK(!erased.Erase(0, 1));
+}
+
+void TestReverseDirection() {
+    DistanceTable table;
+    CHECK(table.Set(3, 1, 100));
+    CHECK(table.Get(3, 1) == 100);
+    CHECK(table.Get(1, 3) == 100);
+    CHECK(table.Set(1, 3, 200));
+    CHECK(!table.Set(1, 3, 200));
+    CHECK(table.Get(3, 1) == 100);
+    CHECK(table.Get(1, 3) == 200);
+    CHECK_EQUAL(table.GetSize(), 1u);
+
+    CHECK(table.Erase(3, 1));
+    CHECK(!table.Erase(3, 1));
+    CHECK(table.Get(3, 1) == 200);
+    CHECK_EQUAL(table.GetSize(), 1u);
+    CHECK(table.Erase(1, 3));
+    CHECK(!table.Get(3, 1));
+    CHECK_EQUAL(table.GetSize(), 0u);
+
+    // Расстояние от остановки до неё самой
+    CHECK(table.Set(5, 5, 10));
+    CHECK(table.Get(5, 5) == 10);
+}
+
+// Случайные операции сверяются с std::map; малое число остановок даёт частые повторы
+// и удаления внутри цепочек проб, большое — расширения таблицы
+void TestMatchesMap() {
+    std::mt19937 random(1);
+    for (StopId stop_count : {4u, 30u, 300u}) {
+        DistanceTable table;
+        Reference reference;
+        std::uniform_int_distribution<StopId> any_stop(0, stop_count - 1);
+        std::uniform_int_distribution<int> any_distance(0, 1000000);
+        for (int i = 0; i < 20000; ++i) {
+            const StopId from = any_stop(random);
+            const StopId to = any_stop(random);
+            if (random() % 3 == 0) {
+                CHECK_EQUAL(table.Erase(from, to), reference.erase({from, to}) == 1);
+            } else {
+                const int distance = any_distance(random);
+                const auto it = reference.find({from, to});
+                CHECK_EQUAL(table.Set(from, to, distance), it == reference.end() || it->second != distance);
+                reference[{from, to}] = distance;
+            }
+            if (i % 5000 == 0 && stop_count <= 30) {
+                CheckContents(table, reference, stop_count);
+            }
+        }
+        CheckContents(table, reference, stop_count);
+    }
+}
+
+void TestReserve() {
+    DistanceTable table;
+    table.Reserve(1000);
+    const size_t capacity = table.GetCapacity();
+    CHECK(capacity * 3 >= 1000 * 4);
+    Reference reference;
+    for (StopId stop = 0; stop < 1000; ++stop) {
+        table.Set(stop, stop + 1, static_cast<int>(stop));
+        reference[{stop, stop + 1}] = static_cast<int>(stop);
+    }
+    // Зарезервированной ёмкости хватает без перестройки
+    CHECK_EQUAL(table.GetCapacity(), capacity);
+    CheckContents(table, reference, 1001);
+    // Уменьшить таблицу Reserve не может
+    table.Reserve(10);
+    CHECK_EQUAL(table.GetCapacity(), capacity);
+}
+
+} // namespace
+
+int main() {
+    RUN_TEST(TestEmpty);
+    RUN_TEST(TestReverseDirection);
+    RUN_TEST(TestMatchesMap);
+    RUN_TEST(TestReserve);
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include <vector>
+
+#include "domain.h"
+#include "testing.h"
+
+using transport_catalogue::Bus;
+using transport_catalogue::StopId;
+
+namespace {
+
+std::vector<StopId> Collect(const Bus& bus) {
+    // Итераторы берутся из разных временных RouteView, которые разрушаются до обхода
+    auto it = bus.GetRoute().begin();
+    const auto end = bus.GetRoute().end();
+    std::vector<StopId> result;
+    for (; it != end; ++it) {
+        result.push_back(*it);
+    }
+    return result;
+}
+
+void TestIteratorOutlivesView() {
+    const std::vector<StopId> stops = {3, 1, 4};
+    const Bus linear{"1", {stops.data(), stops.data() + stops.size()}, false};
+    CHECK(Collect(linear) == (std::vector<StopId>{3, 1, 4, 1, 3}));
+    const Bus round{"2", {stops.data(), stops.data() + stops.size()}, true};
+    CHECK(Collect(round) == stops);
+    const Bus empty{"3", {stops.data(), stops.data()}, false};
+    CHECK(Collect(empty).empty());
+}
+
+} // namespace
+
+int main() {
+    RUN_TEST(TestIteratorOutlivesView);
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "geo.h"
+#include "testing.h"
+
+namespace {
+
+// Пакетный расчёт должен давать те же биты, что и ComputeDistance: от географической длины
+// зависит напечатанная извилистость маршрута
+void CheckPath(const std::vector<double>& lats, const std::vector<double>& lngs, const std::vector<uint32_t>& path) {
+    const geo::CoordinatesView points{lats.data(), lngs.data(), lats.size()};
+    std::vector<geo::PreparedLatitude> latitudes;
+    for (double lat : lats) {
+        latitudes.push_back(geo::PrepareLatitude(lat));
+    }
+    std::vector<double> distances(path.size() - 1, -1.0);
+    geo::ComputeDistances({points, latitudes.data()}, path.data(), distances.size(), distances.data());
+    for (size_t i = 0; i < distances.size(); ++i) {
+        CHECK_EQUAL(distances[i], geo::ComputeDistance(points[path[i]], points[path[i + 1]]));
+    }
+}
+
+void TestMatchesComputeDistance() {
+    std::mt19937 random(1);
+    for (double spread : {1e-6, 0.01, 1.0, 90.0}) {
+        std::uniform_real_distribution<double> lat(-spread, spread);
+        std::uniform_real_distribution<double> lng(-2 * spread, 2 * spread);
+        std::vector<double> lats(200), lngs(200);
+        for (size_t i = 0; i < lats.size(); ++i) {
+            lats[i] = 55.0 * (spread < 90.0) + lat(random);
+            lngs[i] = 37.0 + lng(random);
+        }
+        // Две точки с одинаковыми координатами под разными индексами
+        lats[1] = lats[0];
+        lngs[1] = lngs[0];
+        std::uniform_int_distribution<uint32_t> any_point(0, 199);
+        std::vector<uint32_t> path(1000);
+        for (uint32_t& point : path) {
+            point = any_point(random);
+        }
+        // Повтор точки и переход между совпадающими точками дают нулевые отрезки
+        path[10] = path[11];
+        path[20] = 0;
+        path[21] = 1;
+        CheckPath(lats, lngs, path);
+    }
+}
+
+void TestSymmetric() {
+    // Обратный путь некольцевого маршрута берёт длины отрезков пути в одну сторону
+    std::mt19937 random(2);
+    std::uniform_real_distribution<double> lat(-89.0, 89.0);
+    std::uniform_real_distribution<double> lng(-180.0, 180.0);
+    for (int i = 0; i < 10000; ++i) {
+        const geo::Coordinates from{lat(random), lng(random)};
+        const geo::Coordinates to{lat(random), lng(random)};
+        CHECK_EQUAL(geo::ComputeDistance(from, to), geo::ComputeDistance(to, from));
+    }
+}
+
+void TestEmptyPath() {
+    const double lat = 55.0;
+    const double lng = 37.0;
+    const geo::PreparedLatitude latitude = geo::PrepareLatitude(lat);
+    const uint32_t path[] = {0};
+    double distance = -1.0;
+    geo::ComputeDistances({{&lat, &lng, 1}, &latitude}, path, 0, &distance);
+    geo::ComputeDistancesApprox({lat, lng}, {{&lat, &lng, 1}, &latitude}, path, 0, &distance);
+    CHECK_EQUAL(distance, -1.0);
+}
+
+void TestApproxWithinBound() {
+    std::mt19937 random(3);
+    // Близкие точки, городские расстояния, весь шар и почти диаметрально противоположные точки
+    for (double spread : {1e-7, 1e-3, 0.1, 90.0, -1.0}) {
+        std::uniform_real_distribution<double> offset(-std::abs(spread), std::abs(spread));
+        const geo::Coordinates from{spread < 90.0 && spread > 0 ? 55.0 : 10.0, 37.0};
+        std::vector<double> lats, lngs;
+        for (int i = 0; i < 1001; ++i) {
+            if (spread < 0) {
+                lats.push_back(-from.lat + offset(random) * 1e-3);
+                lngs.push_back(from.lng - 180.0 + offset(random) * 1e-3);
+            } else {
+                lats.push_back(from.lat + offset(random));
+                lngs.push_back(from.lng + 2 * offset(random));
+            }
+        }
+        // Совпадающая с from точка
+        lats[5] = from.lat;
+        lngs[5] = from.lng;
+        std::vector<geo::PreparedLatitude> latitudes;
+        for (double lat : lats) {
+            latitudes.push_back(geo::PrepareLatitude(lat));
+        }
+        // Нечётное число точек проходит и векторную часть, и скалярный хвост
+        std::vector<uint32_t> ids(lats.size());
+        for (uint32_t i = 0; i < ids.size(); ++i) {
+            ids[i] = (i * 7) % ids.size();
+        }
+        const geo::CoordinatesView points{lats.data(), lngs.data(), lats.size()};
+        std::vector<double> distances(ids.size());
+        geo::ComputeDistancesApprox(from, {points, latitudes.data()}, ids.data(), ids.size(), distances.data());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            const double exact = geo::ComputeDistance(from, points[ids[i]]);
+            CHECK(std::abs(distances[i] - exact) <= geo::APPROX_DISTANCE_ERROR);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    RUN_TEST(TestMatchesComputeDistance);
+    RUN_TEST(TestSymmetric);
+    RUN_TEST(TestEmptyPath);
+    RUN_TEST(TestApproxWithinBound);
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "json_reader.h"
+#include "testing.h"
+#include "transport_catalogue.h"
+
+using namespace transport_catalogue;
+using namespace std::literals;
+
+namespace {
+
+std::string StopName(int index) {
+    return "Stop "s + std::to_string(index);
+}
+
+// Цепочка остановок с расстояниями до следующей; автобус i проходит остановки i..i+2.
+// Автобусы идут перед остановками, поэтому часть из них откладывается до конца разбора
+std::string MakeInput(int stop_count, int bad_latitude, int bad_name) {
+    std::ostringstream input;
+    input << "{\"base_requests\": [";
+    for (int i = 0; i + 2 < stop_count; i += 100) {
+        input << "{\"type\": \"Bus\", \"name\": \"" << i << "\", \"is_roundtrip\": false, \"stops\": [\""
+              << StopName(i) << "\", \"" << StopName(i + 1) << "\", \"" << StopName(i + 2) << "\"]},";
+    }
+    for (int i = 0; i < stop_count; ++i) {
+        input << "{\"type\": \"Stop\"";
+        if (i != bad_name) {
+            input << ", \"name\": \"" << StopName(i) << '"';
+        }
+        if (i != bad_latitude) {
+            input << ", \"latitude\": " << 55.0 + i * 1e-4;
+        }
+        input << ", \"longitude\": 37.0, \"road_distances\": {";
+        if (i + 1 < stop_count) {
+            input << '"' << StopName(i + 1) << "\": 100";
+        }
+        input << "}}" << (i + 1 < stop_count ? "," : "");
+    }
+    input << "]}";
+    return input.str();
+}
+
+void TestLoadsAllRequests() {
+    const int stop_count = 5000;
+    std::istringstream input(MakeInput(stop_count, -1, -1));
+    json_reader::JsonReader reader(input);
+    TransportCatalogue catalogue;
+    reader.LoadCatalogueData(catalogue);
+    CHECK_EQUAL(catalogue.GetStopCount(), static_cast<size_t>(stop_count));
+    CHECK_EQUAL(catalogue.GetBusCount(), static_cast<size_t>((stop_count - 3) / 100 + 1));
+    for (int i = 0; i + 2 < stop_count; i += 100) {
+        const auto info = catalogue.GetBusInfo(std::to_string(i));
+        CHECK(info.has_value());
+        CHECK_EQUAL(info->stops_count, 5);
+        // Обратных расстояний нет: берутся прямые
+        CHECK_EQUAL(info->route_length, 400);
+    }
+}
+
+void TestReportsFirstError() {
+    // Ошибки в разных частях, проверяемых разными потоками: сообщается первая в документе
+    for (const auto& [bad_latitude, bad_name] : {std::pair{1500, 4000}, std::pair{4000, 1500}}) {
+        std::istringstream input(MakeInput(5000, bad_latitude, bad_name));
+        json_reader::JsonReader reader(input);
+        TransportCatalogue catalogue;
+        std::string message;
+        try {
+            reader.LoadCatalogueData(catalogue);
+        } catch (const std::invalid_argument& error) {
+            message = error.what();
+        }
+        const bool is_latitude_error = message.find("latitude") != std::string::npos;
+        const bool is_name_error = message.find("name") != std::string::npos;
+        CHECK(bad_latitude < bad_name ? is_latitude_error : is_name_error);
+    }
+}
+
+} // namespace
+
+int main() {
+    RUN_TEST(TestLoadsAllRequests);
+    RUN_TEST(TestReportsFirstError);
+}
\ No newline at end of file
@@ -0,0 +1,633 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "json.h"
+#include "testing.h"
+
+using namespace std::literals;
+
+namespace {
+
+// Строки из букв, пробелов, экранируемых символов и кириллицы
+std::string MakeString(std::mt19937& random) {
+    static const std::string_view parts[] = {"a"sv, "b"sv, " "sv, "\n"sv, "\t"sv, "\r"sv, "\""sv, "\\"sv, "/"sv,
+                                             "ж"sv, "ё"sv, "{"sv, "]"sv, ","sv, ":"sv};
+    std::string result;
+    for (size_t length = random() % 24; length > 0; --length) {
+        result += parts[random() % std::size(parts)];
+    }
+    return result;
+}
+
+double MakeDouble(std::mt19937& random) {
+    std::uniform_real_distribution<double> mantissa(-10.0, 10.0);
+    std::uniform_int_distribution<int> exponent(-30, 30);
+    return mantissa(random) * std::pow(10.0, exponent(random));
+}
+
+json::Node MakeNode(std::mt19937& random, int depth) {
+    switch (random() % (depth > 0 ? 8 : 6)) {
+        case 0:
+            return nullptr;
+        case 1:
+            return random() % 2 == 0;
+        case 2:
+            return static_cast<int>(random());
+        case 3:
+            return MakeDouble(random);
+        case 4:
+        case 5:
+            return MakeString(random);
+        case 6: {
+            json::Array array;
+            for (size_t size = random() % 6; size > 0; --size) {
+                array.push_back(MakeNode(random, depth - 1));
+            }
+            return array;
+        }
+        default: {
+            json::Dict dict;
+            for (size_t size = random() % 6; size > 0; --size) {
+                dict[MakeString(random)] = MakeNode(random, depth - 1);
+            }
+            return dict;
+        }
+    }
+}
+
+// Вывод исходной версии через std::ostream: с ним совпадают ответы программы
+void PrintReference(const json::Node& node, std::ostream& output, int indent) {
+    auto print_indent = [&output](int width) {
+        output << std::string(width, ' ');
+    };
+    auto print_string = [&output](std::string_view value) {
+        output << '"';
+        for (const char c : value) {
+            if (c == '\n') {
+                output << "\\n"sv;
+            } else if (c == '\t') {
+                output << "\\t"sv;
+            } else if (c == '\r') {
+                output << "\\r"sv;
+            } else if (c == '"') {
+                output << "\\\""sv;
+            } else if (c == '\\') {
+                output << "\\\\"sv;
+            } else {
+                output << c;
+            }
+        }
+        output << '"';
+    };
+    if (node.IsArray()) {
+        if (node.AsArray().empty()) {
+            output << "[]"sv;
+            return;
+        }
+        output << "[\n"sv;
+        bool is_first = true;
+        for (const json::Node& item : node.AsArray()) {
+            output << (is_first ? ""sv : ", \n"sv);
+            print_indent(indent + 4);
+            PrintReference(item, output, indent + 4);
+            is_first = false;
+        }
+        output << '\n';
+        print_indent(indent);
+        output << ']';
+    } else if (node.IsMap()) {
+        if (node.AsMap().empty()) {
+            output << "{}"sv;
+            return;
+        }
+        output << "{\n"sv;
+        bool is_first = true;
+        for (const auto& [key, value] : node.AsMap()) {
+            output << (is_first ? ""sv : ", \n"sv);
+            print_indent(indent + 4);
+            print_string(key);
+            output << ": "sv;
+            PrintReference(value, output, indent + 4);
+            is_first = false;
+        }
+        output << '\n';
+        print_indent(indent);
+        output << '}';
+    } else if (node.IsNull()) {
+        output << "null"sv;
+    } else if (node.IsBool()) {
+        output << std::boolalpha << node.AsBool();
+    } else if (node.IsInt()) {
+        output << node.AsInt();
+    } else if (node.IsPureDouble()) {
+        output << node.AsDouble();
+    } else {
+        print_string(node.AsString());
+    }
+}
+
+std::string ToReferenceText(const json::Node& node) {
+    std::ostringstream output;
+    PrintReference(node, output, 0);
+    return output.str();
+}
+
+std::string ToText(const json::Node& node) {
+    std::ostringstream output;
+    json::Print(json::Document(node), output);
+    return output.str();
+}
+
+// Те же события, что WriteNode, но через вызовы Start/Key/Value
+void WriteEvents(json::Writer& writer, const json::Node& node) {
+    if (node.IsArray()) {
+        writer.StartArray();
+        for (const json::Node& item : node.AsArray()) {
+            WriteEvents(writer, item);
+        }
+        writer.EndArray();
+    } else if (node.IsMap()) {
+        writer.StartDict();
+        for (const auto& [key, value] : node.AsMap()) {
+            writer.Key(key);
+            WriteEvents(writer, value);
+        }
+        writer.EndDict();
+    } else if (node.IsNull()) {
+        writer.Value(nullptr);
+    } else if (node.IsBool()) {
+        writer.Value(node.AsBool());
+    } else if (node.IsInt()) {
+        writer.Value(node.AsInt());
+    } else if (node.IsPureDouble()) {
+        writer.Value(node.AsDouble());
+    } else {
+        writer.Value(node.AsString());
+    }
+}
+
+void TestWriterMatchesReference() {
+    std::mt19937 random(1);
+    for (int i = 0; i < 2000; ++i) {
+        const json::Node node = MakeNode(random, 4);
+        const std::string expected = ToReferenceText(node);
+        CHECK_EQUAL(ToText(node), expected);
+        std::ostringstream output;
+        {
+            json::Writer writer(output);
+            WriteEvents(writer, node);
+        }
+        CHECK_EQUAL(output.str(), expected);
+    }
+}
+
+void TestWriterFormat() {
+    json::Dict dict;
+    dict["b"] = json::Array{1, 2.5, "x\"y"s, nullptr, true, json::Array{}, json::Dict{}};
+    dict["a"] = json::Dict{};
+    CHECK_EQUAL(ToText(dict), "{\n"
+                              "    \"a\": {}, \n"
+                              "    \"b\": [\n"
+                              "        1, \n"
+                              "        2.5, \n"
+                              "        \"x\\\"y\", \n"
+                              "        null, \n"
+                              "        true, \n"
+                              "        [], \n"
+                              "        {}\n"
+                              "    ]\n"
+                              "}"s);
+}
+
+// Числа с плавающей точкой пишутся так же, как в поток с настройками по умолчанию
+void TestWriterDoubles() {
+    std::mt19937 random(2);
+    for (int i = 0; i < 100000; ++i) {
+        const double value = MakeDouble(random);
+        std::ostringstream expected;
+        expected << value;
+        CHECK_EQUAL(ToText(value), expected.str());
+    }
+    for (double value : {0.0, -0.0, 1e-5, 1e-4, 123456.0, 1234567.0, 0.1, 1.0 / 3.0, 1e300, -2.5e-300}) {
+        std::ostringstream expected;
+        expected << value;
+        CHECK_EQUAL(ToText(value), expected.str());
+    }
+}
+
+// Вывод больше буфера записи уходит в поток по частям без потерь и перестановок
+void TestWriterFlushesLargeOutput() {
+    std::mt19937 random(3);
+    json::Array array;
+    for (int i = 0; i < 20000; ++i) {
+        array.push_back(MakeNode(random, 2));
+    }
+    const json::Node node(std::move(array));
+    const std::string expected = ToReferenceText(node);
+    CHECK(expected.size() > 4 * (1 << 16));
+    CHECK_EQUAL(ToText(node), expected);
+
+    std::ostringstream output;
+    json::Writer writer(output);
+    writer.WriteNode(node);
+    // До Flush в потоке лежит начало текста, а хвост ещё в буфере
+    CHECK(output.str().size() < expected.size());
+    CHECK_EQUAL(expected.compare(0, output.str().size(), output.str()), 0);
+    writer.Flush();
+    CHECK_EQUAL(output.str(), expected);
+}
+
+
+json::Node LoadText(std::string_view text) {
+    return json::Load(text).GetRoot();
+}
+
+// Тот же документ без отступов, с произвольными пробельными символами между лексемами
+// и иногда без необязательных запятых
+void WriteSpaced(std::mt19937& random, const json::Node& node, std::string& output) {
+    static const std::string_view spaces[] = {""sv, " "sv, "\n"sv, "\t"sv, "\r"sv, "\v"sv, "\f"sv,
+                                              "                    "sv};
+    auto space = [&random, &output]() {
+        output += spaces[random() % std::size(spaces)];
+    };
+    auto separator = [&random, &output](bool is_first) {
+        if (!is_first && random() % 4 != 0) {
+            output += ',';
+        } else if (!is_first) {
+            output += ' ';
+        }
+    };
+    if (node.IsArray()) {
+        output += '[';
+        bool is_first = true;
+        for (const json::Node& item : node.AsArray()) {
+            separator(is_first);
+            space();
+            WriteSpaced(random, item, output);
+            space();
+            is_first = false;
+        }
+        output += ']';
+    } else if (node.IsMap()) {
+        output += '{';
+        bool is_first = true;
+        for (const auto& [key, value] : node.AsMap()) {
+            separator(is_first);
+            space();
+            WriteSpaced(random, key, output);
+            space();
+            output += ':';
+            space();
+            WriteSpaced(random, value, output);
+            space();
+            is_first = false;
+        }
+        output += '}';
+    } else {
+        std::ostringstream text;
+        json::Writer(text).WriteNode(node);
+        output += text.str();
+    }
+}
+
+// Напечатанный документ разбирается в то же дерево; числа с плавающей точкой печатаются
+// с шестью значащими цифрами, поэтому дерево сравнивается после повторной печати
+void TestParseRoundTrip() {
+    std::mt19937 random(4);
+    for (int i = 0; i < 2000; ++i) {
+        const std::string text = ToText(MakeNode(random, 4));
+        const json::Node node = LoadText(text);
+        CHECK_EQUAL(ToText(node), text);
+        std::string spaced;
+        WriteSpaced(random, node, spaced);
+        CHECK(LoadText(spaced) == node);
+        std::istringstream stream(spaced);
+        CHECK(json::Load(stream).GetRoot() == node);
+    }
+}
+
+void TestParseValues() {
+    CHECK(LoadText("null"sv).IsNull());
+    CHECK(LoadText(" true "sv) == json::Node(true));
+    CHECK(LoadText("false"sv) == json::Node(false));
+    CHECK(LoadText("0"sv) == json::Node(0));
+    CHECK(LoadText("-17"sv) == json::Node(-17));
+    CHECK(LoadText("2147483647"sv) == json::Node(2147483647));
+    // Целое вне диапазона int становится числом с плавающей точкой
+    CHECK(LoadText("2147483648"sv) == json::Node(2147483648.0));
+    CHECK(LoadText("-2147483649"sv) == json::Node(-2147483649.0));
+    CHECK(LoadText("1.5"sv) == json::Node(1.5));
+    CHECK(LoadText("-0.25e2"sv) == json::Node(-25.0));
+    CHECK(LoadText("1E-3"sv) == json::Node(1e-3));
+    CHECK(LoadText("5e+2"sv) == json::Node(500.0));
+    CHECK(LoadText("\"a\\n\\t\\r\\\"\\\\b/\""sv) == json::Node("a\n\t\r\"\\b/"s));
+    CHECK(LoadText("\"жёлтый\""sv) == json::Node("жёлтый"s));
+    // Запятые необязательны, а текст после корневого значения не читается
+    CHECK(LoadText("[1 2,3]"sv) == json::Node(json::Array{1, 2, 3}));
+    CHECK(LoadText("{\"a\": 1 \"b\": 2}"sv) == LoadText("{\"b\": 2, \"a\": 1}"sv));
+    CHECK(LoadText("[] trailing"sv) == json::Node(json::Array{}));
+}
+
+void TestParseErrors() {
+    for (std::string_view text : {""sv, "   "sv, "["sv, "[1, 2"sv, "{"sv, "{\"a\": 1"sv, "{\"a\" 1}"sv, "{1: 2}"sv,
+                                  "nul"sv, "nulls"sv, "tru"sv, "falsey"sv, "\"abc"sv, "\"a\\x\""sv, "\"a\\"sv,
+                                  "\"a\nb\""sv, "\"a\rb\""sv, "-"sv, "1."sv, "1e"sv, "1e+"sv, "-a"sv, "@"sv,
+                                  "[1, @]"sv, "]"sv}) {
+        CHECK_THROWS(LoadText(text), json::ParsingError);
+    }
+}
+
+// Пробелы и специальные символы строк на всех позициях относительно блоков по 16 байт
+void TestParseBlockBoundaries() {
+    for (size_t length = 0; length < 40; ++length) {
+        const std::string padding(length, ' ');
+        CHECK(LoadText(padding + "[" + padding + "1" + padding + "]") == json::Node(json::Array{1}));
+        const std::string plain(length, 'x');
+        CHECK(LoadText("\"" + plain + "\"") == json::Node(plain));
+        for (size_t pos = 0; pos <= length; ++pos) {
+            const std::string escaped = plain.substr(0, pos) + "\\\"" + plain.substr(pos);
+            CHECK(LoadText("\"" + escaped + "\"") == json::Node(plain.substr(0, pos) + "\"" + plain.substr(pos)));
+            CHECK_THROWS(LoadText("\"" + plain.substr(0, pos) + "\n" + plain.substr(pos) + "\""), json::ParsingError);
+        }
+        CHECK_THROWS(LoadText("\"" + plain), json::ParsingError);
+    }
+}
+
+// Записывает события разбора в виде строк
+class EventRecorder : public json::Handler {
+public:
+    std::vector<std::string> events;
+
+    void StartArray() override {
+        events.push_back("["s);
+    }
+    void EndArray() override {
+        events.push_back("]"s);
+    }
+    void StartDict() override {
+        events.push_back("{"s);
+    }
+    void Key(std::string_view key) override {
+        events.push_back("key "s + std::string(key));
+    }
+    void EndDict() override {
+        events.push_back("}"s);
+    }
+    void Null() override {
+        events.push_back("null"s);
+    }
+    void Bool(bool value) override {
+        events.push_back(value ? "true"s : "false"s);
+    }
+    void Int(int value) override {
+        events.push_back("int "s + std::to_string(value));
+    }
+    void Double(double value) override {
+        events.push_back("double "s + ToText(value));
+    }
+    void String(std::string_view value) override {
+        events.push_back("string "s + std::string(value));
+    }
+};
+
+// События, которые должен породить напечатанный узел: словари печатаются по возрастанию ключей
+void CollectEvents(const json::Node& node, std::vector<std::string>& events) {
+    if (node.IsArray()) {
+        events.push_back("["s);
+        for (const json::Node& item : node.AsArray()) {
+            CollectEvents(item, events);
+        }
+        events.push_back("]"s);
+    } else if (node.IsMap()) {
+        events.push_back("{"s);
+        for (const auto& [key, value] : node.AsMap()) {
+            events.push_back("key "s + std::string(key));
+            CollectEvents(value, events);
+        }
+        events.push_back("}"s);
+    } else if (node.IsNull()) {
+        events.push_back("null"s);
+    } else if (node.IsBool()) {
+        events.push_back(node.AsBool() ? "true"s : "false"s);
+    } else if (node.IsInt()) {
+        events.push_back("int "s + std::to_string(node.AsInt()));
+    } else if (node.IsPureDouble()) {
+        events.push_back("double "s + ToText(node.AsDouble()));
+    } else {
+        events.push_back("string "s + std::string(node.AsString()));
+    }
+}
+
+void TestParseEvents() {
+    std::mt19937 random(5);
+    for (int i = 0; i < 1000; ++i) {
+        const json::Node node = LoadText(ToText(MakeNode(random, 4)));
+        EventRecorder recorder;
+        json::Parse(ToText(node), recorder);
+        std::vector<std::string> expected;
+        CollectEvents(node, expected);
+        CHECK(recorder.events == expected);
+    }
+    // Ошибка прерывает разбор после уже переданных событий
+    EventRecorder recorder;
+    CHECK_THROWS(json::Parse("[1, {\"a\": tru}]"sv, recorder), json::ParsingError);
+    CHECK((recorder.events == std::vector{"["s, "int 1"s, "{"s, "key a"s}));
+}
+
+void TestTreeBuilder() {
+    json::TreeBuilder builder;
+    CHECK(builder.IsComplete());
+    builder.StartDict();
+    builder.Key("b"sv);
+    builder.StartArray();
+    builder.Int(1);
+    builder.Null();
+    builder.EndArray();
+    CHECK(!builder.IsComplete());
+    builder.Key("a"sv);
+    builder.String("x"sv);
+    builder.EndDict();
+    CHECK(builder.IsComplete());
+    CHECK(builder.Build() == LoadText("{\"a\": \"x\", \"b\": [1, null]}"sv));
+
+    // После завершения значения тот же построитель собирает следующее
+    builder.Double(2.5);
+    CHECK(builder.Build() == json::Node(2.5));
+
+    json::TreeBuilder duplicate;
+    duplicate.StartDict();
+    duplicate.Key("a"sv);
+    duplicate.Bool(true);
+    CHECK_THROWS(duplicate.Key("a"sv), json::ParsingError);
+    CHECK_THROWS(LoadText("{\"a\": 1, \"b\": 2, \"a\": 3}"sv), json::ParsingError);
+    // Одинаковые ключи в разных словарях допустимы
+    CHECK(LoadText("{\"a\": {\"a\": 1}}"sv).AsMap().at("a"sv).AsMap().at("a"sv) == json::Node(1));
+}
+
+void CheckSameDict(const json::Dict& dict, const std::map<std::string, json::Node, std::less<>>& reference) {
+    CHECK_EQUAL(dict.size(), reference.size());
+    CHECK_EQUAL(dict.empty(), reference.empty());
+    CHECK(std::equal(dict.begin(), dict.end(), reference.begin(), reference.end(),
+                     [](const auto& lhs, const auto& rhs) { return lhs.first == rhs.first && lhs.second == rhs.second; }));
+}
+
+// Упорядоченный вектор сверяется с std::map: малые словари ищут подряд, большие — двоичным поиском
+void TestDictMatchesMap() {
+    std::mt19937 random(6);
+    for (size_t key_count : {3, 8, 9, 50, 1000}) {
+        json::Dict dict;
+        std::map<std::string, json::Node, std::less<>> reference;
+        for (int i = 0; i < 3000; ++i) {
+            const std::string key = "k"s + std::to_string(random() % key_count);
+            const int value = static_cast<int>(random() % 100);
+            switch (random() % 4) {
+                case 0:
+                    dict[key] = value;
+                    reference[key] = value;
+                    break;
+                case 1:
+                    if (const auto it = dict.lower_bound(key); it == dict.end() || it->first != key) {
+                        dict.emplace_hint(it, key, value);
+                        reference.emplace(key, value);
+                    }
+                    break;
+                case 2: {
+                    const auto it = dict.find(key);
+                    const auto expected = reference.find(key);
+                    CHECK_EQUAL(it == dict.end(), expected == reference.end());
+                    if (it != dict.end()) {
+                        CHECK_EQUAL(it->first, expected->first);
+                        CHECK(it->second == expected->second);
+                        CHECK(dict.at(key) == expected->second);
+                    } else {
+                        CHECK_THROWS(dict.at(key), std::out_of_range);
+                    }
+                    break;
+                }
+                default: {
+                    const auto it = dict.lower_bound(key);
+                    const auto expected = reference.lower_bound(key);
+                    CHECK_EQUAL(it == dict.end(), expected == reference.end());
+                    if (it != dict.end()) {
+                        CHECK_EQUAL(it->first, expected->first);
+                    }
+                }
+            }
+        }
+        CheckSameDict(dict, reference);
+    }
+}
+
+void TestDictOperations() {
+    json::Dict dict;
+    CHECK(dict.empty());
+    CHECK(dict.find("a"sv) == dict.end());
+    CHECK(dict.lower_bound("a"sv) == dict.end());
+    // Отсутствующий ключ добавляется со значением null
+    CHECK(dict["b"sv].IsNull());
+    dict["a"sv] = 1;
+    dict["c"sv] = 3;
+    CHECK_EQUAL(dict.size(), 3u);
+    CHECK_EQUAL(dict.begin()->first, "a"s);
+    CHECK_EQUAL(dict.lower_bound("bb"sv)->first, "c"s);
+
+    json::Dict other;
+    other["c"sv] = 3;
+    other["b"sv] = nullptr;
+    CHECK(dict != other);
+    other["a"sv] = 1;
+    CHECK(dict == other);
+    other["a"sv] = 2;
+    CHECK(dict != other);
+}
+
+bool IsInside(std::string_view part, std::string_view buffer) {
+    return std::less_equal<>{}(buffer.data(), part.data())
+        && std::less_equal<>{}(part.data() + part.size(), buffer.data() + buffer.size());
+}
+
+// Строка без escape-последовательностей ссылается на входной буфер, иначе — на хранилище
+void CheckStringView(std::string_view value, std::string_view input, const json::StringStorage& storage,
+                     size_t& escaped_count) {
+    if (IsInside(value, input)) {
+        // Ссылка указывает ровно на содержимое строки между кавычками
+        CHECK_EQUAL(value.data()[-1], '"');
+        CHECK_EQUAL(value.data()[value.size()], '"');
+    } else {
+        CHECK(std::any_of(storage.begin(), storage.end(), [value](const std::string& stored) {
+            return stored.data() == value.data() && stored.size() == value.size();
+        }));
+        ++escaped_count;
+    }
+}
+
+// Строки и ключи словарей не копируются в узлы
+void CheckStringViews(const json::Node& node, std::string_view input, const json::StringStorage& storage,
+                      size_t& escaped_count) {
+    if (node.IsArray()) {
+        for (const json::Node& item : node.AsArray()) {
+            CheckStringViews(item, input, storage, escaped_count);
+        }
+    } else if (node.IsMap()) {
+        for (const auto& [key, value] : node.AsMap()) {
+            CHECK(std::holds_alternative<std::string_view>(key.GetValue()));
+            CheckStringView(key, input, storage, escaped_count);
+            CheckStringViews(value, input, storage, escaped_count);
+        }
+    } else if (node.IsString()) {
+        CHECK(std::holds_alternative<std::string_view>(node.GetValue()));
+        CheckStringView(node.AsString(), input, storage, escaped_count);
+    }
+}
+
+void TestZeroCopyLoad() {
+    std::mt19937 random(7);
+    for (int i = 0; i < 1000; ++i) {
+        const std::string input = ToText(MakeNode(random, 4));
+        json::StringStorage storage;
+        const json::Document document = json::Load(input, storage);
+        CHECK(document.GetRoot() == LoadText(input));
+        size_t escaped_count = 0;
+        CheckStringViews(document.GetRoot(), input, storage, escaped_count);
+        CHECK_EQUAL(escaped_count, storage.size());
+    }
+
+    const std::string input = "[\"plain\", \"esc\\naped\", {\"key\": \"value\"}]";
+    json::StringStorage storage;
+    const json::Node root = json::Load(input, storage).GetRoot();
+    CHECK_EQUAL(root.AsArray()[0].AsString().data(), input.data() + 2);
+    CHECK_EQUAL(storage.size(), 1u);
+    CHECK_EQUAL(storage.front(), "esc\naped"s);
+    // Ключи словарей тоже ссылаются на входной буфер
+    CHECK(IsInside(root.AsArray()[2].AsMap().begin()->first, input));
+    // Обычная загрузка копирует строки и ключи
+    const json::Node copied = LoadText(input);
+    CHECK(std::holds_alternative<std::string>(copied.AsArray()[0].GetValue()));
+    CHECK(std::holds_alternative<std::string>(copied.AsArray()[2].AsMap().begin()->first.GetValue()));
+}
+
+} // namespace
+
+int main() {
+    RUN_TEST(TestWriterMatchesReference);
+    RUN_TEST(TestWriterFormat);
+    RUN_TEST(TestWriterDoubles);
+    RUN_TEST(TestWriterFlushesLargeOutput);
+    RUN_TEST(TestParseRoundTrip);
+    RUN_TEST(TestParseValues);
+    RUN_TEST(TestParseErrors);
+    RUN_TEST(TestParseBlockBoundaries);
+    RUN_TEST(TestParseEvents);
+    RUN_TEST(TestTreeBuilder);
+    RUN_TEST(TestDictMatchesMap);
+    RUN_TEST(TestDictOperations);
+    RUN_TEST(TestZeroCopyLoad);
+}
\ No newline at end of file
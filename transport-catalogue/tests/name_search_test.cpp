@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "name_search.h"
+#include "testing.h"
+#include "transport_catalogue.h"
+
+using namespace transport_catalogue;
+
+namespace {
+
+// Латиница и кириллица: символы в один и два байта UTF-8
+const std::u32string ALPHABET = U"abcабв";
+
+std::string EncodeUtf8(const std::u32string& text) {
+    std::string result;
+    for (char32_t symbol : text) {
+        if (symbol < 0x80) {
+            result += static_cast<char>(symbol);
+        } else {
+            result += static_cast<char>(0xC0 | (symbol >> 6));
+            result += static_cast<char>(0x80 | (symbol & 0x3F));
+        }
+    }
+    return result;
+}
+
+std::u32string MakeText(std::mt19937& random, size_t max_length) {
+    std::uniform_int_distribution<size_t> length(0, max_length);
+    std::uniform_int_distribution<size_t> letter(0, ALPHABET.size() - 1);
+    std::u32string text(length(random), U' ');
+    for (char32_t& symbol : text) {
+        symbol = ALPHABET[letter(random)];
+    }
+    return text;
+}
+
+int ComputeLevenshtein(const std::u32string& lhs, const std::u32string& rhs) {
+    std::vector<int> row(rhs.size() + 1);
+    for (size_t j = 0; j <= rhs.size(); ++j) {
+        row[j] = static_cast<int>(j);
+    }
+    for (size_t i = 1; i <= lhs.size(); ++i) {
+        int diagonal = row[0];
+        row[0] = static_cast<int>(i);
+        for (size_t j = 1; j <= rhs.size(); ++j) {
+            const int substitution = diagonal + (lhs[i - 1] == rhs[j - 1] ? 0 : 1);
+            diagonal = row[j];
+            row[j] = std::min({substitution, row[j] + 1, row[j - 1] + 1});
+        }
+    }
+    return row.back();
+}
+
+// Наименьшее расстояние от запроса до какого-либо начала названия
+int ComputePrefixDistance(const std::u32string& query, const std::u32string& name) {
+    int result = INT_MAX;
+    for (size_t length = 0; length <= name.size(); ++length) {
+        result = std::min(result, ComputeLevenshtein(query, name.substr(0, length)));
+    }
+    return result;
+}
+
+struct Names {
+    std::vector<std::u32string> symbols;
+    std::vector<std::string> utf8;
+};
+
+// Различные названия в порядке сортировки байтов UTF-8, как в каталоге
+Names MakeSortedNames(std::mt19937& random, size_t count) {
+    std::vector<std::pair<std::string, std::u32string>> names;
+    for (size_t i = 0; i < count; ++i) {
+        const std::u32string name = MakeText(random, 8);
+        names.push_back({EncodeUtf8(name), name});
+    }
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    Names result;
+    for (auto& [utf8, symbols] : names) {
+        result.utf8.push_back(std::move(utf8));
+        result.symbols.push_back(std::move(symbols));
+    }
+    return result;
+}
+
+// Отсечение по общему началу не должно терять подходящие названия
+void TestMatcherAgainstBruteForce() {
+    std::mt19937 random(1);
+    for (int round = 0; round < 200; ++round) {
+        const Names names = MakeSortedNames(random, 150);
+        const std::u32string query = MakeText(random, 5);
+        int max_errors = static_cast<int>(random() % 4);
+        PrefixMatcher matcher(EncodeUtf8(query), max_errors);
+        for (size_t i = 0; i < names.utf8.size(); ++i) {
+            const int expected = ComputePrefixDistance(query, names.symbols[i]);
+            const auto errors = matcher.Match(names.utf8[i]);
+            if (expected <= max_errors) {
+                CHECK(errors.has_value());
+                CHECK_EQUAL(*errors, expected);
+            } else {
+                CHECK(!errors.has_value());
+            }
+            // Поиск уменьшает порог по мере того, как набирается нужное число названий
+            if (max_errors > 0 && random() % 30 == 0) {
+                matcher.SetMaxErrors(--max_errors);
+            }
+        }
+    }
+}
+
+using Suggestion = std::tuple<int, std::string, NameKind>;
+
+std::vector<Suggestion> ToSuggestions(const std::vector<NameMatch>& matches) {
+    std::vector<Suggestion> result;
+    for (const NameMatch& match : matches) {
+        result.emplace_back(match.errors, std::string(match.name), match.kind);
+    }
+    return result;
+}
+
+void TestSuggestNames() {
+    std::mt19937 random(2);
+    const Names stop_names = MakeSortedNames(random, 300);
+    const Names bus_names = MakeSortedNames(random, 100);
+    TransportCatalogue catalogue;
+    for (const std::string& name : stop_names.utf8) {
+        catalogue.AddStop({name, {55.0, 37.0}});
+    }
+    const StopId first_stop = 0;
+    for (const std::string& name : bus_names.utf8) {
+        catalogue.AddBus({name, {&first_stop, &first_stop + 1}, true});
+    }
+    catalogue.Freeze();
+
+    for (int round = 0; round < 100; ++round) {
+        const std::u32string query = MakeText(random, 4);
+        const int max_errors = static_cast<int>(random() % 4);
+        const size_t count = random() % 20;
+        std::vector<Suggestion> expected;
+        for (size_t i = 0; i < stop_names.symbols.size(); ++i) {
+            if (const int errors = ComputePrefixDistance(query, stop_names.symbols[i]); errors <= max_errors) {
+                expected.emplace_back(errors, stop_names.utf8[i], NameKind::STOP);
+            }
+        }
+        for (size_t i = 0; i < bus_names.symbols.size(); ++i) {
+            if (const int errors = ComputePrefixDistance(query, bus_names.symbols[i]); errors <= max_errors) {
+                expected.emplace_back(errors, bus_names.utf8[i], NameKind::BUS);
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+        expected.resize(std::min(expected.size(), count));
+        CHECK(ToSuggestions(catalogue.SuggestNames(EncodeUtf8(query), count, max_errors)) == expected);
+    }
+}
+
+// Огромный max_errors равносилен длине запроса и не требует памяти пропорционально себе
+void TestHugeMaxErrors() {
+    TransportCatalogue catalogue;
+    for (const char* name : {"Apple", "Apricot", "Banana", "Cherry"}) {
+        catalogue.AddStop({name, {55.0, 37.0}});
+    }
+    catalogue.Freeze();
+    for (std::string_view query : {"", "Ap", "xyz"}) {
+        const auto expected = ToSuggestions(catalogue.SuggestNames(query, 10, static_cast<int>(query.size())));
+        CHECK_EQUAL(expected.size(), 4u);
+        CHECK(ToSuggestions(catalogue.SuggestNames(query, 10, INT_MAX)) == expected);
+        CHECK(ToSuggestions(catalogue.SuggestNames(query, 10, 1000000)) == expected);
+    }
+}
+
+} // namespace
+
+int main() {
+    RUN_TEST(TestMatcherAgainstBruteForce);
+    RUN_TEST(TestSuggestNames);
+    RUN_TEST(TestHugeMaxErrors);
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "perfect_hash.h"
+#include "testing.h"
+
+using transport_catalogue::PerfectHash;
+
+namespace {
+
+std::vector<std::string> MakeKeys(std::mt19937& random, size_t count) {
+    std::uniform_int_distribution<size_t> length(0, 12);
+    std::uniform_int_distribution<int> letter('a', 'e');
+    std::unordered_set<std::string> keys;
+    while (keys.size() < count) {
+        std::string key(length(random), ' ');
+        for (char& c : key) {
+            c = static_cast<char>(letter(random));
+        }
+        keys.insert(key);
+    }
+    return {keys.begin(), keys.end()};
+}
+
+// Каждый ключ находит своё значение; значения — перестановка, поэтому совпадение означает,
+// что ключи попали в разные ячейки
+void CheckKeySet(std::mt19937& random, size_t count) {
+    const std::vector<std::string> keys = MakeKeys(random, count);
+    const std::vector<std::string_view> views(keys.begin(), keys.end());
+    std::vector<uint32_t> values(count);
+    std::iota(values.begin(), values.end(), 0);
+    std::shuffle(values.begin(), values.end(), random);
+
+    PerfectHash hash;
+    hash.Build(views, values);
+    CHECK_EQUAL(hash.GetSize(), count);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(hash.Find(views[i]) == values[i]);
+    }
+    // Отсутствующий ключ даёт значение какого-то ключа набора; проверяет совпадение вызывающий код
+    const auto missing = hash.Find("missing key");
+    CHECK_EQUAL(missing.has_value(), count > 0);
+    CHECK(!missing || *missing < count);
+}
+
+void TestRandomKeySets() {
+    std::mt19937 random(1);
+    for (size_t count : {0, 1, 2, 3, 4, 5, 7, 10, 31, 100, 1000, 10000}) {
+        for (int i = 0; i < 20; ++i) {
+            CheckKeySet(random, count);
+        }
+    }
+    std::uniform_int_distribution<size_t> any_count(0, 300);
+    for (int i = 0; i < 500; ++i) {
+        CheckKeySet(random, any_count(random));
+    }
+}
+
+void TestRebuild() {
+    PerfectHash hash;
+    CHECK(!hash.Find("key"));
+    const std::vector<std::string_view> keys = {"a", "b", "c"};
+    hash.Build(keys, {7, 8, 9});
+    hash.Build({}, {});
+    CHECK(!hash.Find("a"));
+    hash.Build(keys, {7, 8, 9});
+    CHECK(hash.Find("c") == 9u);
+}
+
+void TestDuplicateKeys() {
+    PerfectHash hash;
+    CHECK_THROWS(hash.Build({"a", "b", "a", "c"}, {0, 1, 2, 3}), std::logic_error);
+}
+
+} // namespace
+
+int main() {
+    RUN_TEST(TestRandomKeySets);
+    RUN_TEST(TestRebuild);
+    RUN_TEST(TestDuplicateKeys);
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+# Запускает программу на образце запросов и сравнивает ответы с ожидаемыми.
+# MODE=direct — один запуск без аргументов, MODE=snapshot — make_base и process_requests
+# на том же файле: каждый режим читает из него только свои разделы
+
+if (MODE STREQUAL "snapshot")
+    execute_process(COMMAND ${PROGRAM} make_base INPUT_FILE ${INPUT} RESULT_VARIABLE result)
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "make_base failed: ${result}")
+    endif()
+    execute_process(COMMAND ${PROGRAM} process_requests INPUT_FILE ${INPUT} OUTPUT_FILE ${OUTPUT}
+                    RESULT_VARIABLE result)
+else()
+    execute_process(COMMAND ${PROGRAM} INPUT_FILE ${INPUT} OUTPUT_FILE ${OUTPUT} RESULT_VARIABLE result)
+endif()
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "${PROGRAM} failed: ${result}")
+endif()
+
+execute_process(COMMAND ${COMPARE} ${EXPECTED} ${OUTPUT} RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "Answers differ from ${EXPECTED}")
+endif()
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "spatial_index.h"
+
+using transport_catalogue::SpatialIndex;
+using transport_catalogue::StopId;
+
+// Замер скорости запросов к индексу остановок; в ctest не входит.
+// Аргументы: число остановок, число запросов, число ближайших остановок в запросе
+int main(int argc, char* argv[]) {
+    const size_t stop_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    const size_t query_count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    const size_t count = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1;
+
+    // Остановки и запросы равномерно распределены по прямоугольнику размером с большой город
+    std::mt19937 random(1);
+    std::uniform_real_distribution<double> lat(55.5, 55.9);
+    std::uniform_real_distribution<double> lng(37.3, 37.9);
+    std::vector<double> lats(stop_count), lngs(stop_count);
+    std::vector<StopId> stop_ids(stop_count);
+    for (size_t i = 0; i < stop_count; ++i) {
+        lats[i] = lat(random);
+        lngs[i] = lng(random);
+        stop_ids[i] = static_cast<StopId>(i);
+    }
+    std::vector<geo::Coordinates> queries(query_count);
+    for (geo::Coordinates& query : queries) {
+        query = {lat(random), lng(random)};
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const geo::CoordinatesView stops{lats.data(), lngs.data(), stop_count};
+    SpatialIndex index;
+    const auto build_start = Clock::now();
+    index.Build(stops, std::move(stop_ids));
+    const auto build_end = Clock::now();
+
+    // Сумма расстояний не даёт компилятору выбросить запросы
+    double checksum = 0.0;
+    const auto query_start = Clock::now();
+    for (const geo::Coordinates& query : queries) {
+        for (const auto& stop : index.FindNearest(stops, query, count)) {
+            checksum += stop.distance;
+        }
+    }
+    const auto query_end = Clock::now();
+
+    const double build_ms = std::chrono::duration<double, std::milli>(build_end - build_start).count();
+    const double query_s = std::chrono::duration<double>(query_end - query_start).count();
+    std::cout << "stops: " << stop_count << ", build: " << build_ms << " ms" << std::endl;
+    std::cout << "nearest " << count << ": " << query_count << " queries in " << query_s << " s, "
+              << query_count / query_s << " queries/s (checksum " << checksum << ")" << std::endl;
+}
\ No newline at end of file
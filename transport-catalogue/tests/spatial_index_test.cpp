@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "spatial_index.h"
+#include "testing.h"
+
+using transport_catalogue::NearbyStop;
+using transport_catalogue::SpatialIndex;
+using transport_catalogue::StopId;
+
+namespace {
+
+struct Stops {
+    std::vector<double> lats;
+    std::vector<double> lngs;
+    std::vector<geo::PreparedLatitude> latitudes;
+    // Удалённые из каталога остановки не попадают в индекс
+    std::vector<StopId> indexed;
+
+    geo::CoordinatesView GetView() const {
+        return {lats.data(), lngs.data(), lats.size()};
+    }
+    geo::PreparedCoordinatesView GetPreparedView() const {
+        return {GetView(), latitudes.data()};
+    }
+};
+
+Stops MakeStops(std::mt19937& random, size_t count, geo::BoundingBox area) {
+    std::uniform_real_distribution<double> lat(area.min.lat, area.max.lat);
+    std::uniform_real_distribution<double> lng(area.min.lng, area.max.lng);
+    Stops stops;
+    for (StopId stop_id = 0; stop_id < count; ++stop_id) {
+        stops.lats.push_back(lat(random));
+        stops.lngs.push_back(lng(random));
+        if (random() % 10 != 0) {
+            stops.indexed.push_back(stop_id);
+        }
+    }
+    // Совпадающие точки
+    if (count > 3) {
+        stops.lats[1] = stops.lats[0];
+        stops.lngs[1] = stops.lngs[0];
+    }
+    for (double stop_lat : stops.lats) {
+        stops.latitudes.push_back(geo::PrepareLatitude(stop_lat));
+    }
+    return stops;
+}
+
+// Все проиндексированные остановки по возрастанию расстояния, при равенстве — идентификатора
+std::vector<NearbyStop> SortByDistance(const Stops& stops, geo::Coordinates point) {
+    std::vector<NearbyStop> result;
+    for (StopId stop_id : stops.indexed) {
+        result.push_back({stop_id, geo::ComputeDistance(point, stops.GetView()[stop_id])});
+    }
+    std::sort(result.begin(), result.end(), [](const NearbyStop& lhs, const NearbyStop& rhs) {
+        return lhs.distance < rhs.distance || (lhs.distance == rhs.distance && lhs.id < rhs.id);
+    });
+    return result;
+}
+
+void CheckNearest(const SpatialIndex& index, const Stops& stops, geo::Coordinates point, size_t count) {
+    const auto result = index.FindNearest(stops.GetView(), point, count);
+    const auto expected = SortByDistance(stops, point);
+    const size_t expected_size = std::min(count, expected.size());
+    CHECK_EQUAL(result.size(), expected_size);
+    for (size_t i = 0; i < result.size(); ++i) {
+        CHECK_EQUAL(result[i].distance, geo::ComputeDistance(point, stops.GetView()[result[i].id]));
+        // Ближайшие ищутся по хорде, поэтому почти равные расстояния могут идти в другом порядке
+        CHECK(std::abs(result[i].distance - expected[i].distance) <= 1e-6 * (1.0 + expected[i].distance));
+    }
+}
+
+void CheckRadius(const SpatialIndex& index, const Stops& stops, geo::Coordinates point, double radius) {
+    const auto result = index.FindInRadius(stops.GetPreparedView(), point, radius);
+    std::vector<StopId> expected;
+    for (const NearbyStop& stop : SortByDistance(stops, point)) {
+        if (stop.distance <= radius) {
+            expected.push_back(stop.id);
+        }
+    }
+    std::vector<StopId> found;
+    for (size_t i = 0; i < result.size(); ++i) {
+        CHECK(result[i].distance <= radius);
+        CHECK(i == 0 || result[i - 1].distance <= result[i].distance + 1e-6);
+        found.push_back(result[i].id);
+    }
+    std::sort(found.begin(), found.end());
+    std::sort(expected.begin(), expected.end());
+    CHECK(found == expected);
+}
+
+void CheckBox(const SpatialIndex& index, const Stops& stops, const geo::BoundingBox& box) {
+    std::vector<StopId> expected;
+    for (StopId stop_id : stops.indexed) {
+        if (box.Contains(stops.GetView()[stop_id])) {
+            expected.push_back(stop_id);
+        }
+    }
+    CHECK(index.FindInBox(stops.GetView(), box) == expected);
+}
+
+void TestMatchesBruteForce() {
+    std::mt19937 random(1);
+    const geo::BoundingBox city{{55.5, 37.3}, {55.9, 37.9}};
+    const geo::BoundingBox world{{-89.0, -180.0}, {89.0, 180.0}};
+    for (const auto& area : {city, world}) {
+        for (size_t count : {0, 1, 2, 7, 100, 1000}) {
+            const Stops stops = MakeStops(random, count, area);
+            SpatialIndex index;
+            index.Build(stops.GetView(), stops.indexed);
+            CHECK_EQUAL(index.GetSize(), stops.indexed.size());
+
+            std::uniform_real_distribution<double> lat(area.min.lat, area.max.lat);
+            std::uniform_real_distribution<double> lng(area.min.lng, area.max.lng);
+            const double scale = geo::ComputeDistance(area.min, area.max);
+            std::uniform_real_distribution<double> radius(0.0, scale / 4);
+            for (int i = 0; i < 50; ++i) {
+                const geo::Coordinates point{lat(random), lng(random)};
+                CheckNearest(index, stops, point, 1 + random() % 10);
+                CheckNearest(index, stops, point, count + 5);
+                CheckRadius(index, stops, point, radius(random));
+                const geo::Coordinates corner{lat(random), lng(random)};
+                CheckBox(index, stops, {{std::min(point.lat, corner.lat), std::min(point.lng, corner.lng)},
+                                        {std::max(point.lat, corner.lat), std::max(point.lng, corner.lng)}});
+            }
+            if (count > 0) {
+                // Точка самой остановки и весь охватывающий прямоугольник
+                CheckNearest(index, stops, stops.GetView()[0], 3);
+                CheckRadius(index, stops, stops.GetView()[0], 0.0);
+                CheckBox(index, stops, area);
+            }
+            CHECK(index.FindNearest(stops.GetView(), area.min, 0).empty());
+            CHECK(index.FindInRadius(stops.GetPreparedView(), area.min, -1.0).empty());
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    RUN_TEST(TestMatchesBruteForce);
+}
\ No newline at end of file
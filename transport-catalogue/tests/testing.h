@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+
+// Проверки тестов действуют и при NDEBUG: при ошибке печатают место и условие и завершают тест.
+// CHECK_EQUAL копирует значения: ссылка на часть временного объекта не пережила бы выражение
+
+#define CHECK(condition)                                                                              \
+    do {                                                                                              \
+        if (!(condition)) {                                                                           \
+            std::cerr << __FILE__ << ':' << __LINE__ << ": CHECK(" #condition ") failed" << std::endl; \
+            std::exit(1);                                                                             \
+        }                                                                                             \
+    } while (false)
+
+#define CHECK_EQUAL(lhs, rhs)                                                                         \
+    do {                                                                                              \
+        const auto check_lhs = (lhs);                                                                 \
+        const auto check_rhs = (rhs);                                                                 \
+        if (!(check_lhs == check_rhs)) {                                                              \
+            std::cerr << __FILE__ << ':' << __LINE__ << ": CHECK_EQUAL(" #lhs ", " #rhs ") failed: "   \
+                      << check_lhs << " != " << check_rhs << std::endl;                               \
+            std::exit(1);                                                                             \
+        }                                                                                             \
+    } while (false)
+
+// Выбрасывает ли выражение исключение типа Exception
+#define CHECK_THROWS(expression, Exception)                                                           \
+    do {                                                                                              \
+        bool check_thrown = false;                                                                    \
+        try {                                                                                         \
+            (void)(expression);                                                                       \
+        } catch (const Exception&) {                                                                  \
+            check_thrown = true;                                                                      \
+        }                                                                                             \
+        CHECK(check_thrown);                                                                          \
+    } while (false)
+
+inline void RunTest(const char* name, void (*test)()) {
+    test();
+    std::cerr << name << " OK" << std::endl;
+}
+
+#define RUN_TEST(test) RunTest(#test, test)
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "testing.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+using namespace transport_catalogue;
+using transport_router::RouterSettings;
+using transport_router::TransportRouter;
+
+namespace {
+
+// Случайный каталог: остановки в квадрате около 3 км, автобусы по случайным остановкам,
+// расстояния для каждого отрезка маршрутов и иногда для обратного направления
+struct RandomCatalogue {
+    std::vector<std::string> names;
+    TransportCatalogue catalogue;
+
+    RandomCatalogue(std::mt19937& random, size_t stop_count, size_t bus_count) {
+        for (size_t i = 0; i < stop_count + bus_count; ++i) {
+            names.push_back((i < stop_count ? "Stop " : "Bus ") + std::to_string(i));
+        }
+        std::uniform_real_distribution<double> lat(55.60, 55.63);
+        std::uniform_real_distribution<double> lng(37.60, 37.65);
+        std::uniform_int_distribution<size_t> any_stop(0, stop_count - 1);
+        std::uniform_int_distribution<int> distance(100, 3000);
+        std::uniform_int_distribution<size_t> route_size(2, 8);
+
+        CatalogueData data;
+        for (size_t i = 0; i < stop_count; ++i) {
+            data.stops.push_back({names[i], {lat(random), lng(random)}});
+        }
+        for (size_t i = 0; i < bus_count; ++i) {
+            const size_t begin = data.bus_stops.size();
+            const size_t size = route_size(random);
+            const bool is_round = random() % 2 == 0;
+            for (size_t j = 0; j < size; ++j) {
+                data.bus_stops.push_back(names[any_stop(random)]);
+            }
+            if (is_round) {
+                data.bus_stops.push_back(data.bus_stops[begin]);
+            }
+            for (size_t j = begin + 1; j < data.bus_stops.size(); ++j) {
+                data.distances.push_back({data.bus_stops[j - 1], data.bus_stops[j], distance(random)});
+                if (random() % 3 == 0) {
+                    data.distances.push_back({data.bus_stops[j], data.bus_stops[j - 1], distance(random)});
+                }
+            }
+            data.buses.push_back({names[stop_count + i], begin, data.bus_stops.size(), is_round});
+        }
+        catalogue.Update({std::move(data), {}, {}, {}});
+    }
+};
+
+void CheckSameRoute(const std::optional<transport_router::RouteInfo>& actual,
+                    const std::optional<transport_router::RouteInfo>& expected) {
+    CHECK_EQUAL(actual.has_value(), expected.has_value());
+    if (!actual) {
+        return;
+    }
+    CHECK_EQUAL(actual->total_time, expected->total_time);
+    CHECK_EQUAL(actual->items.size(), expected->items.size());
+    for (size_t i = 0; i < actual->items.size(); ++i) {
+        const auto& actual_item = actual->items[i];
+        const auto& expected_item = expected->items[i];
+        CHECK(actual_item.type == expected_item.type);
+        CHECK_EQUAL(actual_item.name, expected_item.name);
+        CHECK(actual_item.span_count == expected_item.span_count);
+        CHECK_EQUAL(actual_item.time, expected_item.time);
+    }
+}
+
+// Все ответы маршрутизатора совпадают с ответами маршрутизатора, построенного заново
+void CheckSameAnswers(const TransportCatalogue& catalogue, const TransportRouter& actual,
+                      const TransportRouter& expected, std::mt19937& random) {
+    for (StopId from = 0; from < catalogue.GetStopCount(); ++from) {
+        for (StopId to = 0; to < catalogue.GetStopCount(); ++to) {
+            CheckSameRoute(actual.GetRouteInfo(from, to), expected.GetRouteInfo(from, to));
+        }
+    }
+    std::uniform_real_distribution<double> lat(55.59, 55.64);
+    std::uniform_real_distribution<double> lng(37.59, 37.66);
+    for (int i = 0; i < 100; ++i) {
+        const geo::Coordinates from{lat(random), lng(random)};
+        const geo::Coordinates to{lat(random), lng(random)};
+        CheckSameRoute(actual.GetRouteInfo(from, to), expected.GetRouteInfo(from, to));
+    }
+}
+
+void TestSetSettingsMatchesRebuild() {
+    std::mt19937 random(26);
+    const std::vector<RouterSettings> settings_list = {
+        {6.0, 40.0},
+        {1.0, 30.0, 4.0, 1500.0},
+        {20.0, 12.5, 6.0, 500.0},
+        {0.0, 1.0},
+        {6.0, 40.0},
+    };
+    for (const auto& [stop_count, bus_count] : std::vector<std::pair<size_t, size_t>>{{2, 1}, {30, 10}, {120, 40}}) {
+        const RandomCatalogue data(random, stop_count, bus_count);
+        TransportRouter router(data.catalogue, settings_list.front());
+        for (const RouterSettings& settings : settings_list) {
+            router.SetSettings(settings);
+            CHECK_EQUAL(router.GetSettings().bus_velocity, settings.bus_velocity);
+            CHECK_EQUAL(router.GetSettings().bus_wait_time, settings.bus_wait_time);
+            const TransportRouter rebuilt(data.catalogue, settings);
+            CheckSameAnswers(data.catalogue, router, rebuilt, random);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    RUN_TEST(TestSetSettingsMatchesRebuild);
+}
\ No newline at end of file
@@ -1,91 +1,807 @@
 #include "transport_catalogue.h"
 
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
 #include <unordered_set>
 
 namespace transport_catalogue {
 
-void TransportCatalogue::AddStop(const Stop& stop) {
-    stops_.push_back(stop);
-    std::string_view stop_name{stops_.back().name};
-    stopname_to_stop_[stop_name] = &stops_.back();
-    stopname_to_busnames_[stop_name] = {};
+namespace {
+
+std::string_view GetName(std::string_view name) {
+    return name;
+}
+
+std::string_view GetName(const Bus& bus) {
+    return bus.name;
 }
 
-Stop* TransportCatalogue::FindStop(std::string_view stop_name) const {
-    if (stopname_to_stop_.count(stop_name) > 0) {
-        return stopname_to_stop_.at(stop_name);
+// Убирает из упорядоченных по названию идентификаторов удалённые и вливает добавленные
+// после прошлой заморозки: сортируются только новые, слияние линейно
+template <typename Item>
+void MergeSortedIds(std::vector<uint32_t>& ids, size_t frozen_count, const std::vector<Item>& items,
+                    const std::vector<bool>& removed) {
+    ids.erase(std::remove_if(ids.begin(), ids.end(), [&removed](uint32_t id) { return removed[id]; }), ids.end());
+    const size_t middle = ids.size();
+    for (size_t id = frozen_count; id < items.size(); ++id) {
+        if (!removed[id]) {
+            ids.push_back(static_cast<uint32_t>(id));
+        }
     }
-    return nullptr;
+    auto by_name = [&items](uint32_t lhs, uint32_t rhs) {
+        return GetName(items[lhs]) < GetName(items[rhs]);
+    };
+    std::sort(ids.begin() + middle, ids.end(), by_name);
+    std::inplace_merge(ids.begin(), ids.begin() + middle, ids.end(), by_name);
+}
+
+// Лучшие count совпадений среди названий одного вида. Без правок подходящие названия
+// занимают непрерывный отрезок; при нечётком поиске порог правок снижается, как только
+// набрано count названий с меньшим числом правок: дальше названия идут по возрастанию
+template <typename Item>
+void CollectNameMatches(std::vector<NameMatch>& result, NameKind kind, const std::vector<uint32_t>& sorted_ids,
+                        const std::vector<Item>& items, std::string_view query, size_t count, int max_errors) {
+    auto has_prefix = [&items](uint32_t id, std::string_view prefix) {
+        return GetName(items[id]).substr(0, prefix.size()) == prefix;
+    };
+    if (max_errors == 0) {
+        auto it = std::lower_bound(sorted_ids.begin(), sorted_ids.end(), query, [&items](uint32_t id, std::string_view name) {
+            return GetName(items[id]) < name;
+        });
+        for (size_t found = 0; found < count && it != sorted_ids.end() && has_prefix(*it, query); ++found, ++it) {
+            result.push_back({kind, *it, GetName(items[*it]), 0});
+        }
+        return;
+    }
+
+    PrefixMatcher matcher(query, max_errors);
+    std::vector<size_t> found(max_errors + 1, 0);
+    int limit = max_errors;
+    for (auto it = sorted_ids.begin(); it != sorted_ids.end() && count != 0;) {
+        const std::string_view name = GetName(items[*it]);
+        if (auto errors = matcher.Match(name); errors.has_value()) {
+            result.push_back({kind, *it, name, *errors});
+            ++found[*errors];
+            while (limit >= 0 && std::accumulate(found.begin(), found.begin() + limit + 1, size_t{0}) >= count) {
+                --limit;
+            }
+            if (limit < 0) {
+                break;
+            }
+            matcher.SetMaxErrors(limit);
+            ++it;
+        } else if (const size_t pruned = matcher.GetPrunedLength(); pruned != 0) {
+            const std::string_view prefix = name.substr(0, pruned);
+            it = std::partition_point(it, sorted_ids.end(), [&has_prefix, prefix](uint32_t id) {
+                return has_prefix(id, prefix);
+            });
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace
+
+void TransportCatalogue::Reserve(size_t stop_count, size_t bus_count, size_t distance_count) {
+    stop_names_.reserve(stop_count);
+    stop_lats_.reserve(stop_count);
+    stop_lngs_.reserve(stop_count);
+    stop_latitudes_.reserve(stop_count);
+    removed_stops_.reserve(stop_count);
+    stopname_to_id_.reserve(stop_count);
+    buses_.reserve(bus_count);
+    removed_buses_.reserve(bus_count);
+    busname_to_id_.reserve(bus_count);
+    bus_infos_.reserve(bus_count);
+    route_lengths_.reserve(bus_count);
+    distances_.Reserve(distance_count);
 }
 
-std::unordered_map<std::string_view, Stop*> TransportCatalogue::GetStopList() const {
-    return stopname_to_stop_;
+void TransportCatalogue::CopyFrom(const TransportCatalogue& other) {
+    using namespace std::literals;
+
+    if (!stop_names_.empty() || !buses_.empty() || distances_.GetSize() != 0) {
+        throw std::logic_error("The catalogue is not empty"s);
+    }
+    Reserve(other.stop_names_.size(), other.buses_.size(), other.distances_.GetSize());
+    for (StopId stop_id = 0; stop_id < other.stop_names_.size(); ++stop_id) {
+        AddStop(other.GetStop(stop_id));
+    }
+    other.distances_.ForEach([this](StopId from, StopId to, int distance) {
+        distances_.Set(from, to, distance);
+    });
+    for (const Bus& bus : other.buses_) {
+        AddBus(bus);
+    }
+    for (BusId bus_id = 0; bus_id < other.buses_.size(); ++bus_id) {
+        if (other.removed_buses_[bus_id]) {
+            RemoveBus(bus_id);
+        }
+    }
+    for (StopId stop_id = 0; stop_id < other.stop_names_.size(); ++stop_id) {
+        if (other.removed_stops_[stop_id]) {
+            RemoveStop(stop_id);
+        }
+    }
+    Freeze();
 }
 
-void TransportCatalogue::AddBus(const Bus& bus) {
+TransportCatalogue::State TransportCatalogue::GetState() const {
+    CheckFrozen();
+    return {stop_names_, stop_lats_, stop_lngs_, removed_stops_, buses_, removed_buses_, distances_.GetState(),
+            stop_name_hash_.GetState(), bus_name_hash_.GetState(), bus_infos_, route_lengths_, sorted_stop_ids_,
+            sorted_bus_ids_, stop_bus_offsets_, stop_bus_ids_, stop_index_.GetState()};
+}
+
+void TransportCatalogue::Restore(State state) {
+    using namespace std::literals;
+
+    if (!stop_names_.empty() || !buses_.empty() || distances_.GetSize() != 0) {
+        throw std::logic_error("The catalogue is not empty"s);
+    }
+    const size_t stop_count = state.stop_names.size();
+    const size_t bus_count = state.buses.size();
+    if (state.stop_lats.size() != stop_count || state.stop_lngs.size() != stop_count
+            || state.removed_stops.size() != stop_count || state.removed_buses.size() != bus_count
+            || state.bus_infos.size() != bus_count || state.route_lengths.size() != bus_count
+            || state.stop_bus_offsets.size() != stop_count + 1 || state.stop_bus_offsets.back() != state.stop_bus_ids.size()
+            || !std::is_sorted(state.stop_bus_offsets.begin(), state.stop_bus_offsets.end())) {
+        throw std::invalid_argument("Inconsistent catalogue state"s);
+    }
+    for (BusId bus_id = 0; bus_id < bus_count; ++bus_id) {
+        const size_t route_size = state.buses[bus_id].GetRoute().size();
+        const RouteLengths& lengths = state.route_lengths[bus_id];
+        if (lengths.geo.size() != route_size || (!lengths.road.empty() && lengths.road.size() != route_size)) {
+            throw std::invalid_argument("Inconsistent catalogue state"s);
+        }
+    }
+    distances_.SetState(std::move(state.distances));
+    stop_name_hash_.SetState(std::move(state.stop_name_hash));
+    bus_name_hash_.SetState(std::move(state.bus_name_hash));
+    stop_index_.SetState(std::move(state.stop_index));
+    stop_names_ = std::move(state.stop_names);
+    stop_lats_ = std::move(state.stop_lats);
+    stop_lngs_ = std::move(state.stop_lngs);
+    stop_latitudes_.resize(stop_count);
+    std::transform(stop_lats_.begin(), stop_lats_.end(), stop_latitudes_.begin(), geo::PrepareLatitude);
+    removed_stops_ = std::move(state.removed_stops);
+    buses_ = std::move(state.buses);
+    removed_buses_ = std::move(state.removed_buses);
+    bus_infos_ = std::move(state.bus_infos);
+    route_lengths_ = std::move(state.route_lengths);
+    sorted_stop_ids_ = std::move(state.sorted_stop_ids);
+    sorted_bus_ids_ = std::move(state.sorted_bus_ids);
+    stop_bus_offsets_ = std::move(state.stop_bus_offsets);
+    stop_bus_ids_ = std::move(state.stop_bus_ids);
+    stale_buses_begin_ = bus_count;
+    frozen_stop_count_ = stop_count;
+    frozen_bus_count_ = bus_count;
+    is_frozen_ = true;
+}
+
+UpdateReport TransportCatalogue::Update(const CatalogueUpdate& update) {
+    const CatalogueData& data = update.data;
+    for (const Stop& stop : data.stops) {
+        if (auto stop_id = FindStopId(stop.name); stop_id.has_value()) {
+            SetStopCoordinates(*stop_id, stop.coordinates);
+        } else {
+            AddStop(stop);
+        }
+    }
+    for (const auto& [from, to, distance] : data.distances) {
+        AddDistance(ResolveStop(from), ResolveStop(to), distance);
+    }
+    for (const auto& [from, to] : update.removed_distances) {
+        RemoveDistance(ResolveStop(from), ResolveStop(to));
+    }
+    for (std::string_view bus_name : update.removed_buses) {
+        RemoveBus(ResolveBus(bus_name));
+    }
+    std::vector<StopId> route;
+    for (const BusData& bus : data.buses) {
+        route.clear();
+        for (size_t i = bus.stops_begin; i < bus.stops_end; ++i) {
+            route.push_back(ResolveStop(data.bus_stops[i]));
+        }
+        const ranges::Range<const StopId*> stops{route.data(), route.data() + route.size()};
+        if (auto bus_id = FindBusId(bus.name); bus_id.has_value()) {
+            SetBusRoute(*bus_id, stops, bus.is_round);
+        } else {
+            AddBus({bus.name, stops, bus.is_round});
+        }
+    }
+    for (std::string_view stop_name : update.removed_stops) {
+        RemoveStop(ResolveStop(stop_name));
+    }
+    return FreezeChanges();
+}
+
+StopId TransportCatalogue::AddStop(const Stop& stop) {
+    return InsertStop(StoreName(stop.name), stop.coordinates);
+}
+
+StopId TransportCatalogue::AdoptStop(const Stop& stop) {
+    return InsertStop(stop.name, stop.coordinates);
+}
+
+StopId TransportCatalogue::InsertStop(std::string_view name, geo::Coordinates coordinates) {
+    const StopId stop_id = static_cast<StopId>(stop_names_.size());
+    stop_names_.push_back(name);
+    stop_lats_.push_back(coordinates.lat);
+    stop_lngs_.push_back(coordinates.lng);
+    stop_latitudes_.push_back(geo::PrepareLatitude(coordinates.lat));
+    removed_stops_.push_back(false);
+    stopname_to_id_[stop_names_.back()] = stop_id;
+    pending_changes_.sorted_stops = true;
+    pending_changes_.stop_index = true;
+    pending_changes_.route_graph = true;
+    is_frozen_ = false;
+    return stop_id;
+}
+
+std::optional<Stop> TransportCatalogue::FindStop(std::string_view stop_name) const {
+    if (auto stop_id = FindStopId(stop_name); stop_id.has_value()) {
+        return GetStop(*stop_id);
+    }
+    return std::nullopt;
+}
+
+std::optional<StopId> TransportCatalogue::FindStopId(std::string_view stop_name) const {
+    if (!stopname_to_id_.empty()) {
+        if (auto it = stopname_to_id_.find(stop_name); it != stopname_to_id_.end()) {
+            return it->second;
+        }
+    }
+    if (auto stop_id = stop_name_hash_.Find(stop_name);
+        stop_id.has_value() && !removed_stops_[*stop_id] && stop_names_[*stop_id] == stop_name) {
+        return stop_id;
+    }
+    return std::nullopt;
+}
+
+Stop TransportCatalogue::GetStop(StopId stop_id) const {
+    return {stop_names_[stop_id], {stop_lats_[stop_id], stop_lngs_[stop_id]}};
+}
+
+size_t TransportCatalogue::GetStopCount() const {
+    return stop_names_.size();
+}
+
+geo::CoordinatesView TransportCatalogue::GetStopCoordinates() const {
+    return {stop_lats_.data(), stop_lngs_.data(), stop_names_.size()};
+}
+
+void TransportCatalogue::SetStopCoordinates(StopId stop_id, geo::Coordinates coordinates) {
+    if (GetStop(stop_id).coordinates == coordinates) {
+        return;
+    }
+    stop_lats_[stop_id] = coordinates.lat;
+    stop_lngs_[stop_id] = coordinates.lng;
+    stop_latitudes_[stop_id] = geo::PrepareLatitude(coordinates.lat);
+    // Координаты входят в географическую длину маршрутов, проходящих через остановку
+    InvalidateBusInfos(stop_id);
+    pending_changes_.stop_index = true;
+    is_frozen_ = false;
+}
+
+void TransportCatalogue::RemoveStop(StopId stop_id) {
+    using namespace std::literals;
+
+    if (removed_stops_[stop_id]) {
+        return;
+    }
+    if (IsStopUsed(stop_id)) {
+        throw std::invalid_argument("The stop "s + std::string(stop_names_[stop_id]) + " is used by buses"s);
+    }
+    // Название могло перейти к остановке, добавленной позже
+    if (auto it = stopname_to_id_.find(stop_names_[stop_id]); it != stopname_to_id_.end() && it->second == stop_id) {
+        stopname_to_id_.erase(it);
+    }
+    removed_stops_[stop_id] = true;
+    pending_changes_.sorted_stops = true;
+    pending_changes_.stop_index = true;
+    is_frozen_ = false;
+}
+
+bool TransportCatalogue::IsStopRemoved(StopId stop_id) const {
+    return removed_stops_[stop_id];
+}
+
+BusId TransportCatalogue::AddBus(const Bus& bus) {
+    return InsertBus({StoreName(bus.name), StoreStops(bus.stops), bus.is_round});
+}
+
+BusId TransportCatalogue::AdoptBus(const Bus& bus) {
+    return InsertBus({bus.name, StoreStops(bus.stops), bus.is_round});
+}
+
+BusId TransportCatalogue::InsertBus(const Bus& bus) {
+    const BusId bus_id = static_cast<BusId>(buses_.size());
     buses_.push_back(bus);
-    std::string_view bus_name{buses_.back().name};
-    busname_to_bus_[bus_name] = &buses_.back();
-    for (auto stop : buses_.back().stops) {
-        std::string_view stop_name{stop->name};
-        stopname_to_busnames_.at(stop_name).insert(bus_name);
+    removed_buses_.push_back(false);
+    busname_to_id_[buses_.back().name] = bus_id;
+    bus_infos_.emplace_back();
+    route_lengths_.emplace_back();
+    UpdateBusInfo(bus_id);
+    if (stale_buses_begin_ == bus_id) {
+        ++stale_buses_begin_;
     }
+    pending_changes_.bus_infos.push_back(bus_id);
+    pending_changes_.sorted_buses = true;
+    pending_changes_.stop_buses = true;
+    pending_changes_.route_graph = true;
+    is_frozen_ = false;
+    return bus_id;
 }
 
-Bus* TransportCatalogue::FindBus(std::string_view bus_name) const {
-    if (busname_to_bus_.count(bus_name) > 0) {
-        return busname_to_bus_.at(bus_name);
+const Bus* TransportCatalogue::FindBus(std::string_view bus_name) const {
+    if (auto bus_id = FindBusId(bus_name); bus_id.has_value()) {
+        return &buses_[*bus_id];
     }
     return nullptr;
 }
 
-std::unordered_map<std::string_view, Bus*> TransportCatalogue::GetBusList() const {
-    return busname_to_bus_;
+std::optional<BusId> TransportCatalogue::FindBusId(std::string_view bus_name) const {
+    if (!busname_to_id_.empty()) {
+        if (auto it = busname_to_id_.find(bus_name); it != busname_to_id_.end()) {
+            return it->second;
+        }
+    }
+    if (auto bus_id = bus_name_hash_.Find(bus_name);
+        bus_id.has_value() && !removed_buses_[*bus_id] && buses_[*bus_id].name == bus_name) {
+        return bus_id;
+    }
+    return std::nullopt;
+}
+
+const Bus& TransportCatalogue::GetBus(BusId bus_id) const {
+    return buses_[bus_id];
+}
+
+size_t TransportCatalogue::GetBusCount() const {
+    return buses_.size();
+}
+
+TransportCatalogue::BusRange TransportCatalogue::GetBuses() const {
+    return ranges::AsRange(buses_);
+}
+
+void TransportCatalogue::SetBusRoute(BusId bus_id, ranges::Range<const StopId*> stops, bool is_round) {
+    // Прежний маршрут остаётся в арене до удаления каталога
+    Bus& bus = buses_[bus_id];
+    bus.stops = StoreStops(stops);
+    bus.is_round = is_round;
+    UpdateBusInfo(bus_id);
+    rerouted_buses_.push_back(bus_id);
+    pending_changes_.bus_infos.push_back(bus_id);
+    pending_changes_.stop_buses = true;
+    pending_changes_.route_graph = true;
+    is_frozen_ = false;
+}
+
+void TransportCatalogue::RemoveBus(BusId bus_id) {
+    if (removed_buses_[bus_id]) {
+        return;
+    }
+    Bus& bus = buses_[bus_id];
+    if (auto it = busname_to_id_.find(bus.name); it != busname_to_id_.end() && it->second == bus_id) {
+        busname_to_id_.erase(it);
+    }
+    bus.stops = {bus.stops.begin(), bus.stops.begin()};
+    removed_buses_[bus_id] = true;
+    bus_infos_[bus_id].reset();
+    route_lengths_[bus_id] = {};
+    pending_changes_.bus_infos.push_back(bus_id);
+    pending_changes_.sorted_buses = true;
+    pending_changes_.stop_buses = true;
+    pending_changes_.route_graph = true;
+    is_frozen_ = false;
+}
+
+bool TransportCatalogue::IsBusRemoved(BusId bus_id) const {
+    return removed_buses_[bus_id];
 }
 
 std::optional<BusInfo> TransportCatalogue::GetBusInfo(std::string_view bus_name) const {
-    if (busname_to_bus_.count(bus_name) == 0) {
+    if (auto bus_id = FindBusId(bus_name); bus_id.has_value()) {
+        return GetBusInfo(*bus_id);
+    }
+    return std::nullopt;
+}
+
+BusInfo TransportCatalogue::GetBusInfo(BusId bus_id) const {
+    if (const auto& info = bus_infos_[bus_id]; info.has_value() && bus_id < stale_buses_begin_) {
+        return *info;
+    }
+    const Bus& bus = buses_[bus_id];
+    return ComputeBusInfo(bus, ComputeRouteLengths(bus)).value();
+}
+
+std::optional<TransportCatalogue::BusIdRange> TransportCatalogue::GetStopInfo(std::string_view stop_name) const {
+    if (auto stop_id = FindStopId(stop_name); stop_id.has_value()) {
+        return GetStopInfo(*stop_id);
+    }
+    return std::nullopt;
+}
+
+TransportCatalogue::BusIdRange TransportCatalogue::GetStopInfo(StopId stop_id) const {
+    CheckFrozen();
+    return {stop_bus_ids_.begin() + stop_bus_offsets_[stop_id], stop_bus_ids_.begin() + stop_bus_offsets_[stop_id + 1]};
+}
+
+void TransportCatalogue::AddDistance(StopId from, StopId to, int distance) {
+    if (!distances_.Set(from, to, distance)) {
+        return;
+    }
+    // Расстояние в обе стороны используется только маршрутами, проходящими через from
+    InvalidateBusInfos(from);
+    pending_changes_.route_graph = true;
+    is_frozen_ = false;
+}
+
+std::optional<int> TransportCatalogue::GetDistance(StopId from, StopId to) const {
+    return distances_.Get(from, to);
+}
+
+std::optional<int> TransportCatalogue::GetRouteDistance(BusId bus_id, size_t from, size_t to) const {
+    CheckFrozen();
+    const std::vector<int>& road = route_lengths_[bus_id].road;
+    if (road.empty()) {
+        return std::nullopt;
+    }
+    return road[to] - road[from];
+}
+
+double TransportCatalogue::GetRouteGeoDistance(BusId bus_id, size_t from, size_t to) const {
+    CheckFrozen();
+    const std::vector<double>& geo = route_lengths_[bus_id].geo;
+    return geo[to] - geo[from];
+}
+
+bool TransportCatalogue::RemoveDistance(StopId from, StopId to) {
+    if (!distances_.Erase(from, to)) {
+        return false;
+    }
+    InvalidateBusInfos(from);
+    pending_changes_.route_graph = true;
+    is_frozen_ = false;
+    return true;
+}
+
+void TransportCatalogue::Freeze() {
+    FreezeChanges();
+}
+
+UpdateReport TransportCatalogue::FreezeChanges() {
+    UpdateReport report = std::move(pending_changes_);
+    pending_changes_ = {};
+    if (report.sorted_stops) {
+        MergeSortedIds(sorted_stop_ids_, frozen_stop_count_, stop_names_, removed_stops_);
+    }
+    if (report.sorted_buses) {
+        MergeSortedIds(sorted_bus_ids_, frozen_bus_count_, buses_, removed_buses_);
+    }
+    BuildNameHashes(report);
+    for (BusId bus_id = 0; bus_id < buses_.size(); ++bus_id) {
+        if (removed_buses_[bus_id]) {
+            continue;
+        }
+        if (bus_id >= stale_buses_begin_) {
+            report.bus_infos.push_back(bus_id);
+        }
+        if (!bus_infos_[bus_id].has_value() || bus_id >= stale_buses_begin_) {
+            UpdateBusInfo(bus_id);
+        }
+    }
+    stale_buses_begin_ = buses_.size();
+    if (report.stop_buses) {
+        BuildStopBusLists();
+    } else {
+        // Новые остановки без автобусов получают пустые списки
+        stop_bus_offsets_.resize(stop_names_.size() + 1, stop_bus_offsets_.empty() ? 0 : stop_bus_offsets_.back());
+    }
+    if (report.stop_index) {
+        BuildStopIndex();
+    }
+    frozen_stop_count_ = stop_names_.size();
+    frozen_bus_count_ = buses_.size();
+    is_frozen_ = true;
+
+    std::sort(report.bus_infos.begin(), report.bus_infos.end());
+    report.bus_infos.erase(std::unique(report.bus_infos.begin(), report.bus_infos.end()), report.bus_infos.end());
+    return report;
+}
+
+bool TransportCatalogue::IsFrozen() const {
+    return is_frozen_;
+}
+
+TransportCatalogue::StopIdRange TransportCatalogue::GetStopIdsSortedByName() const {
+    CheckFrozen();
+    return ranges::AsRange(sorted_stop_ids_);
+}
+
+TransportCatalogue::BusIdRange TransportCatalogue::GetBusIdsSortedByName() const {
+    CheckFrozen();
+    return ranges::AsRange(sorted_bus_ids_);
+}
+
+std::vector<NearbyStop> TransportCatalogue::NearestStops(geo::Coordinates coordinates, size_t count) const {
+    CheckFrozen();
+    return stop_index_.FindNearest(GetStopCoordinates(), coordinates, count);
+}
+
+std::vector<StopId> TransportCatalogue::StopsInBox(const geo::BoundingBox& box) const {
+    CheckFrozen();
+    std::vector<StopId> result = stop_index_.FindInBox(GetStopCoordinates(), box);
+    std::sort(result.begin(), result.end(), [this](StopId lhs, StopId rhs) {
+        return stop_names_[lhs] < stop_names_[rhs];
+    });
+    return result;
+}
+
+std::vector<NearbyStop> TransportCatalogue::StopsInRadius(geo::Coordinates coordinates, double radius) const {
+    CheckFrozen();
+    return stop_index_.FindInRadius(GetPreparedStopCoordinates(), coordinates, radius);
+}
+
+std::vector<NameMatch> TransportCatalogue::SuggestNames(std::string_view query, size_t count, int max_errors) const {
+    CheckFrozen();
+    // Запрос превращается в пустое начало любого названия удалением всех символов, поэтому больше
+    // правок, чем символов в запросе, не нужно; память поиска пропорциональна этому числу
+    if (max_errors > 0 && static_cast<size_t>(max_errors) > query.size()) {
+        max_errors = static_cast<int>(query.size());
+    }
+    std::vector<NameMatch> result;
+    CollectNameMatches(result, NameKind::STOP, sorted_stop_ids_, stop_names_, query, count, max_errors);
+    CollectNameMatches(result, NameKind::BUS, sorted_bus_ids_, buses_, query, count, max_errors);
+    std::sort(result.begin(), result.end(), [](const NameMatch& lhs, const NameMatch& rhs) {
+        return std::tie(lhs.errors, lhs.name, lhs.kind) < std::tie(rhs.errors, rhs.name, rhs.kind);
+    });
+    result.resize(std::min(result.size(), count));
+    return result;
+}
+
+memory_stats::MemoryStats TransportCatalogue::GetMemoryStats() const {
+    using namespace memory_stats;
+    MemoryStats stats;
+    stats.Add("stop_names", GetVectorUsage(stop_names_));
+    Usage stop_coordinates = GetVectorUsage(stop_lats_);
+    stop_coordinates.bytes += GetVectorUsage(stop_lngs_).bytes;
+    stats.Add("stop_coordinates", stop_coordinates);
+    stats.Add("stop_latitudes", GetVectorUsage(stop_latitudes_));
+    stats.Add("removed_stops", GetVectorUsage(removed_stops_));
+    stats.Add("stopname_to_id", GetHashMapUsage(stopname_to_id_));
+    stats.Add("stop_name_hash", stop_name_hash_.GetMemoryUsage());
+    stats.Add("buses", GetVectorUsage(buses_));
+    stats.Add("removed_buses", GetVectorUsage(removed_buses_));
+    stats.Add("busname_to_id", GetHashMapUsage(busname_to_id_));
+    stats.Add("bus_name_hash", bus_name_hash_.GetMemoryUsage());
+    stats.Add("bus_infos", GetVectorUsage(bus_infos_));
+    Usage route_lengths = GetVectorUsage(route_lengths_);
+    for (const RouteLengths& lengths : route_lengths_) {
+        route_lengths.bytes += GetVectorUsage(lengths.road).bytes + GetVectorUsage(lengths.geo).bytes;
+    }
+    stats.Add("route_lengths", route_lengths);
+    stats.Add("distances", distances_.GetMemoryUsage());
+    stats.Add("sorted_stop_ids", GetVectorUsage(sorted_stop_ids_));
+    stats.Add("sorted_bus_ids", GetVectorUsage(sorted_bus_ids_));
+    Usage stop_buses = GetVectorUsage(stop_bus_ids_);
+    stop_buses.bytes += GetVectorUsage(stop_bus_offsets_).bytes;
+    stats.Add("stop_buses", stop_buses);
+    stats.Add("stop_index", stop_index_.GetMemoryUsage());
+    stats.Add("arena", arena_usage_);
+    return stats;
+}
+
+void TransportCatalogue::CheckFrozen() const {
+    using namespace std::literals;
+    if (!is_frozen_) {
+        throw std::logic_error("The catalogue is not frozen"s);
+    }
+}
+
+geo::PreparedCoordinatesView TransportCatalogue::GetPreparedStopCoordinates() const {
+    return {GetStopCoordinates(), stop_latitudes_.data()};
+}
+
+TransportCatalogue::RouteLengths TransportCatalogue::ComputeRouteLengths(const Bus& bus) const {
+    const RouteView route = bus.GetRoute();
+    RouteLengths lengths;
+    if (route.empty()) {
+        return lengths;
+    }
+    lengths.road.reserve(route.size());
+    lengths.road.push_back(0);
+    for (size_t i = 0; i + 1 < route.size(); ++i) {
+        auto distance = GetDistance(route[i], route[i + 1]);
+        if (!distance.has_value()) {
+            lengths.road.clear();
+            break;
+        }
+        lengths.road.push_back(lengths.road.back() + *distance);
+    }
+    // Географические длины отрезков пути в одну сторону считаются пакетно по подготовленным широтам остановок;
+    // обратный путь некольцевого маршрута проходит те же отрезки, а расстояние симметрично
+    const size_t segment_count = bus.stops.size() - 1;
+    lengths.geo.resize(route.size());
+    geo::ComputeDistances(GetPreparedStopCoordinates(), bus.stops.begin(), segment_count, lengths.geo.data() + 1);
+    for (size_t i = segment_count; i + 1 < route.size(); ++i) {
+        lengths.geo[i + 1] = lengths.geo[2 * segment_count - i];
+    }
+    lengths.geo[0] = 0.0;
+    std::partial_sum(lengths.geo.begin(), lengths.geo.end(), lengths.geo.begin());
+    return lengths;
+}
+
+std::optional<BusInfo> TransportCatalogue::ComputeBusInfo(const Bus& bus, const RouteLengths& lengths) const {
+    if (lengths.road.size() != bus.GetRoute().size()) {
         return std::nullopt;
     }
     BusInfo info;
-    Bus bus = *busname_to_bus_.at(bus_name);
-    info.stops_count = bus.stops.size();
-    std::unordered_set<Stop*> unique_stops(bus.stops.begin(), bus.stops.end());
+    info.stops_count = lengths.road.size();
+    std::unordered_set<StopId> unique_stops(bus.stops.begin(), bus.stops.end());
     info.unique_stops_count = unique_stops.size();
-    int route_length = 0;
-    double route_length_geo = 0.0;
-    for (size_t i = 0; i < bus.stops.size() - 1; ++i) {
-        route_length += GetDistance(bus.stops[i]->name, bus.stops[i + 1]->name).value();
-        route_length_geo += ComputeDistance(bus.stops[i]->coordinates, bus.stops[i + 1]->coordinates);
-    }
+    const int route_length = lengths.road.empty() ? 0 : lengths.road.back();
+    const double route_length_geo = lengths.geo.empty() ? 0.0 : lengths.geo.back();
     info.route_length = route_length;
     info.curvature = route_length / route_length_geo;
     return info;
 }
 
-std::optional<std::set<std::string_view>> TransportCatalogue::GetStopInfo(std::string_view stop_name) const {
-    if (stopname_to_busnames_.count(stop_name) == 0) {
-        return std::nullopt;
+void TransportCatalogue::UpdateBusInfo(BusId bus_id) {
+    const Bus& bus = buses_[bus_id];
+    route_lengths_[bus_id] = ComputeRouteLengths(bus);
+    bus_infos_[bus_id] = ComputeBusInfo(bus, route_lengths_[bus_id]);
+}
+
+void TransportCatalogue::InvalidateBusInfos(StopId stop_id) {
+    // Списки автобусов остановок построены при последней заморозке: автобусы, добавленные
+    // после неё, считаются устаревшими целиком, а изменённые маршруты перебираются отдельно
+    auto reset = [this](BusId bus_id) {
+        bus_infos_[bus_id].reset();
+        pending_changes_.bus_infos.push_back(bus_id);
+    };
+    const size_t known_stop_count = stop_bus_offsets_.empty() ? 0 : stop_bus_offsets_.size() - 1;
+    if (stop_id < known_stop_count) {
+        for (size_t i = stop_bus_offsets_[stop_id]; i < stop_bus_offsets_[stop_id + 1]; ++i) {
+            reset(stop_bus_ids_[i]);
+        }
+    }
+    for (BusId bus_id : rerouted_buses_) {
+        reset(bus_id);
+    }
+    stale_buses_begin_ = std::min<BusId>(stale_buses_begin_, frozen_bus_count_);
+}
+
+bool TransportCatalogue::IsStopUsed(StopId stop_id) const {
+    auto uses = [this, stop_id](BusId bus_id) {
+        const Bus& bus = buses_[bus_id];
+        return !removed_buses_[bus_id] && std::find(bus.stops.begin(), bus.stops.end(), stop_id) != bus.stops.end();
+    };
+    const size_t known_stop_count = stop_bus_offsets_.empty() ? 0 : stop_bus_offsets_.size() - 1;
+    if (stop_id < known_stop_count) {
+        for (size_t i = stop_bus_offsets_[stop_id]; i < stop_bus_offsets_[stop_id + 1]; ++i) {
+            if (uses(stop_bus_ids_[i])) {
+                return true;
+            }
+        }
+    }
+    if (std::any_of(rerouted_buses_.begin(), rerouted_buses_.end(), uses)) {
+        return true;
+    }
+    for (BusId bus_id = frozen_bus_count_; bus_id < buses_.size(); ++bus_id) {
+        if (uses(bus_id)) {
+            return true;
+        }
     }
-    return stopname_to_busnames_.at(stop_name);
+    return false;
 }
 
-void TransportCatalogue::AddDistance(std::string_view from, std::string_view to, int distance) {
-    std::pair<Stop*, Stop*> way = {FindStop(from), FindStop(to)};
-    distances_[way] = distance;
+StopId TransportCatalogue::ResolveStop(std::string_view stop_name) const {
+    using namespace std::literals;
+    if (auto stop_id = FindStopId(stop_name); stop_id.has_value()) {
+        return *stop_id;
+    }
+    throw std::invalid_argument("The stop "s + std::string(stop_name) + " is not found"s);
 }
 
-std::optional<int> TransportCatalogue::GetDistance(std::string_view stop1, std::string_view stop2) const {
-    Stop* stop1_p = FindStop(stop1);
-    Stop* stop2_p = FindStop(stop2);
-    if (stop1_p && stop2_p) {
-        if (distances_.count({stop1_p, stop2_p}) > 0) {
-            return distances_.at({stop1_p, stop2_p});
-        } else if (distances_.count({stop2_p, stop1_p}) > 0) {
-            return distances_.at({stop2_p, stop1_p});
+BusId TransportCatalogue::ResolveBus(std::string_view bus_name) const {
+    using namespace std::literals;
+    if (auto bus_id = FindBusId(bus_name); bus_id.has_value()) {
+        return *bus_id;
+    }
+    throw std::invalid_argument("The bus "s + std::string(bus_name) + " is not found"s);
+}
+
+void TransportCatalogue::BuildStopBusLists() {
+    // Автобусы перебираются в порядке названий, поэтому списки получаются отсортированными.
+    // last_bus защищает от повторного учёта остановки, встречающейся в маршруте несколько раз
+    constexpr BusId NO_BUS = UINT32_MAX;
+    std::vector<BusId> last_bus(stop_names_.size(), NO_BUS);
+    stop_bus_offsets_.assign(stop_names_.size() + 1, 0);
+    for (BusId bus_id : sorted_bus_ids_) {
+        for (StopId stop_id : buses_[bus_id].stops) {
+            if (last_bus[stop_id] != bus_id) {
+                last_bus[stop_id] = bus_id;
+                ++stop_bus_offsets_[stop_id + 1];
+            }
         }
     }
-    return std::nullopt;
+    for (size_t i = 1; i < stop_bus_offsets_.size(); ++i) {
+        stop_bus_offsets_[i] += stop_bus_offsets_[i - 1];
+    }
+    stop_bus_ids_.resize(stop_bus_offsets_.back());
+    std::vector<size_t> positions(stop_bus_offsets_.begin(), stop_bus_offsets_.end() - 1);
+    last_bus.assign(stop_names_.size(), NO_BUS);
+    for (BusId bus_id : sorted_bus_ids_) {
+        for (StopId stop_id : buses_[bus_id].stops) {
+            if (last_bus[stop_id] != bus_id) {
+                last_bus[stop_id] = bus_id;
+                stop_bus_ids_[positions[stop_id]++] = bus_id;
+            }
+        }
+    }
+    rerouted_buses_.clear();
+}
+
+void TransportCatalogue::BuildStopIndex() {
+    std::vector<StopId> stop_ids;
+    stop_ids.reserve(stop_names_.size());
+    for (StopId stop_id = 0; stop_id < stop_names_.size(); ++stop_id) {
+        if (!removed_stops_[stop_id]) {
+            stop_ids.push_back(stop_id);
+        }
+    }
+    stop_index_.Build(GetStopCoordinates(), std::move(stop_ids));
+}
+
+void TransportCatalogue::BuildNameHashes(const UpdateReport& report) {
+    // Повторно добавленное название принадлежит той остановке или автобусу, на который оно указывает сейчас
+    auto collect_names = [](const auto& sorted_ids, const auto& items, auto find_id) {
+        std::pair<std::vector<std::string_view>, std::vector<uint32_t>> names;
+        names.first.reserve(sorted_ids.size());
+        names.second.reserve(sorted_ids.size());
+        for (uint32_t id : sorted_ids) {
+            if (find_id(GetName(items[id])) == id) {
+                names.first.push_back(GetName(items[id]));
+                names.second.push_back(id);
+            }
+        }
+        return names;
+    };
+    if (report.sorted_stops) {
+        auto [names, ids] = collect_names(sorted_stop_ids_, stop_names_, [this](std::string_view name) {
+            return FindStopId(name);
+        });
+        stop_name_hash_.Build(names, ids);
+        stopname_to_id_ = {};
+    }
+    if (report.sorted_buses) {
+        auto [names, ids] = collect_names(sorted_bus_ids_, buses_, [this](std::string_view name) {
+            return FindBusId(name);
+        });
+        bus_name_hash_.Build(names, ids);
+        busname_to_id_ = {};
+    }
+}
+
+std::string_view TransportCatalogue::StoreName(std::string_view name) {
+    arena_usage_ += {1, name.size()};
+    char* data = static_cast<char*>(arena_.allocate(name.size(), alignof(char)));
+    std::memcpy(data, name.data(), name.size());
+    return {data, name.size()};
+}
+
+ranges::Range<const StopId*> TransportCatalogue::StoreStops(ranges::Range<const StopId*> stops) {
+    arena_usage_ += {1, stops.size() * sizeof(StopId)};
+    StopId* data = static_cast<StopId*>(arena_.allocate(stops.size() * sizeof(StopId), alignof(StopId)));
+    std::copy(stops.begin(), stops.end(), data);
+    return {data, data + stops.size()};
 }
 
 }
\ No newline at end of file
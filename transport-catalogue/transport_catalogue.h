@@ -1,18 +1,21 @@
 #pragma once
 
-#include <deque>
-#include <functional>
-#include <map>
+#include <memory_resource>
 #include <optional>
-#include <set>
 #include <string>
 #include <string_view>
-#include <utility>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "distance_table.h"
 #include "domain.h"
 #include "geo.h"
+#include "memory_stats.h"
+#include "name_search.h"
+#include "perfect_hash.h"
+#include "ranges.h"
+#include "spatial_index.h"
 
 namespace transport_catalogue {
 
@@ -23,36 +26,231 @@ struct BusInfo {
 	double curvature;
 };
 
-class PairPointersHasher {
-public:
+struct DistanceData {
+	std::string_view from;
+	std::string_view to;
+	int distance;
+};
 
-	std::size_t operator()(const std::pair<Stop*, Stop*>& pair) const {
-		return hasher_(pair.first) * 37 + hasher_(pair.second);
-	}
+struct BusData {
+	std::string_view name;
+	// Остановки маршрута — полуинтервал [stops_begin, stops_end) массива CatalogueData::bus_stops
+	size_t stops_begin;
+	size_t stops_end;
+	bool is_round;
+};
 
-private:
-	std::hash<const void*> hasher_;
+// Пакет остановок, расстояний и автобусов; строки копируются в каталог только при вызове Update
+struct CatalogueData {
+	std::vector<Stop> stops;
+	std::vector<DistanceData> distances;
+	std::vector<BusData> buses;
+	std::vector<std::string_view> bus_stops;
+};
+
+// Пакет изменений каталога; строки копируются в каталог только при вызове Update
+struct CatalogueUpdate {
+	// Новые остановки, расстояния и автобусы; для существующих остановок меняются координаты,
+	// для существующих автобусов — маршрут
+	CatalogueData data;
+	std::vector<std::pair<std::string_view, std::string_view>> removed_distances;
+	std::vector<std::string_view> removed_buses;
+	std::vector<std::string_view> removed_stops;
+};
+
+// Производные данные, которые затронули изменения каталога
+struct UpdateReport {
+	// Автобусы, статистика которых вычислена заново, по возрастанию идентификаторов
+	std::vector<BusId> bus_infos;
+	bool sorted_stops = false;
+	bool sorted_buses = false;
+	bool stop_buses = false;
+	bool stop_index = false;
+	// Изменились маршруты или расстояния, по которым строится граф маршрутизатора
+	bool route_graph = false;
 };
 
 class TransportCatalogue {
 public:
-	void AddStop(const Stop& stop);
-	Stop* FindStop(std::string_view stop_name) const;
-	std::unordered_map<std::string_view, Stop*> GetStopList() const;
-	void AddBus(const Bus& bus);
-	Bus* FindBus(std::string_view bus_name) const;
-	std::unordered_map<std::string_view, Bus*> GetBusList() const;
+	using BusRange = ranges::Range<std::vector<Bus>::const_iterator>;
+	using StopIdRange = ranges::Range<std::vector<StopId>::const_iterator>;
+	using BusIdRange = ranges::Range<std::vector<BusId>::const_iterator>;
+
+	// Префиксные суммы длин отрезков полного маршрута: длина участка — разность двух элементов
+	struct RouteLengths {
+		// Пусто, если для какого-то отрезка нет расстояния по дорогам
+		std::vector<int> road;
+		std::vector<double> geo;
+	};
+
+	// Замороженный каталог вместе с производными индексами в плоском виде: снимок на диске сохраняет
+	// его и восстанавливает каталог без повторного построения индексов. Названия и последовательности
+	// остановок не копируются при восстановлении и должны жить дольше каталога
+	struct State {
+		std::vector<std::string_view> stop_names;
+		std::vector<double> stop_lats;
+		std::vector<double> stop_lngs;
+		std::vector<bool> removed_stops;
+		std::vector<Bus> buses;
+		std::vector<bool> removed_buses;
+		DistanceTable::State distances;
+		PerfectHash::State stop_name_hash;
+		PerfectHash::State bus_name_hash;
+		std::vector<std::optional<BusInfo>> bus_infos;
+		std::vector<RouteLengths> route_lengths;
+		std::vector<StopId> sorted_stop_ids;
+		std::vector<BusId> sorted_bus_ids;
+		std::vector<size_t> stop_bus_offsets;
+		std::vector<BusId> stop_bus_ids;
+		SpatialIndex::State stop_index;
+	};
+
+	TransportCatalogue() = default;
+	TransportCatalogue(const TransportCatalogue&) = delete;
+	TransportCatalogue& operator=(const TransportCatalogue&) = delete;
+
+	// Резервирует место под указанное общее число элементов
+	void Reserve(size_t stop_count, size_t bus_count, size_t distance_count);
+	// Копирует данные другого каталога с теми же идентификаторами, резервируя память точно
+	// под их объём, и замораживает каталог. Выбрасывает std::logic_error, если каталог не пуст
+	void CopyFrom(const TransportCatalogue& other);
+	// Состояние замороженного каталога; выбрасывает std::logic_error, если каталог не заморожен
+	State GetState() const;
+	// Принимает состояние, полученное GetState, и считает каталог замороженным. Выбрасывает
+	// std::logic_error, если каталог не пуст, и std::invalid_argument, если длины массивов
+	// не согласованы; ссылки между массивами проверяет вызывающий код
+	void Restore(State state);
+	// Применяет пакет изменений в порядке: остановки, расстояния, удаление расстояний, удаление
+	// автобусов, автобусы, удаление остановок — и замораживает каталог, перестраивая только
+	// затронутые индексы. Выбрасывает std::invalid_argument при ссылке на неизвестную остановку
+	// или автобус и при удалении остановки, через которую проходят автобусы; применённые
+	// до ошибки изменения сохраняются
+	UpdateReport Update(const CatalogueUpdate& update);
+	StopId AddStop(const Stop& stop);
+	// Добавляет остановку, не копируя название: строка должна жить дольше каталога
+	StopId AdoptStop(const Stop& stop);
+	std::optional<Stop> FindStop(std::string_view stop_name) const;
+	std::optional<StopId> FindStopId(std::string_view stop_name) const;
+	Stop GetStop(StopId stop_id) const;
+	size_t GetStopCount() const;
+	// Координаты всех остановок, включая удалённые, в плотных массивах по идентификатору
+	geo::CoordinatesView GetStopCoordinates() const;
+	void SetStopCoordinates(StopId stop_id, geo::Coordinates coordinates);
+	// Удаляет остановку, через которую не проходят автобусы. Идентификатор не переиспользуется,
+	// название освобождается. Выбрасывает std::invalid_argument, если остановка используется
+	void RemoveStop(StopId stop_id);
+	bool IsStopRemoved(StopId stop_id) const;
+	BusId AddBus(const Bus& bus);
+	// Добавляет автобус, не копируя название: строка должна жить дольше каталога.
+	// Последовательность остановок копируется
+	BusId AdoptBus(const Bus& bus);
+	const Bus* FindBus(std::string_view bus_name) const;
+	std::optional<BusId> FindBusId(std::string_view bus_name) const;
+	const Bus& GetBus(BusId bus_id) const;
+	size_t GetBusCount() const;
+	// Автобусы в порядке идентификаторов, включая удалённые (с пустым маршрутом)
+	BusRange GetBuses() const;
+	void SetBusRoute(BusId bus_id, ranges::Range<const StopId*> stops, bool is_round);
+	// Удаляет автобус; идентификатор не переиспользуется, название освобождается
+	void RemoveBus(BusId bus_id);
+	bool IsBusRemoved(BusId bus_id) const;
+	// Статистика маршрута вычисляется при добавлении автобуса и пересчитывается
+	// при заморозке каталога, если изменились расстояния между его остановками
 	std::optional<BusInfo> GetBusInfo(std::string_view bus_name) const;
-	std::optional<std::set<std::string_view>> GetStopInfo(std::string_view stop_name) const;
-	void AddDistance(std::string_view from, std::string_view to, int distance);
-	std::optional<int> GetDistance(std::string_view from, std::string_view to) const;
+	BusInfo GetBusInfo(BusId bus_id) const;
+	// Автобусы, проходящие через остановку, в порядке названий (доступны после Freeze)
+	std::optional<BusIdRange> GetStopInfo(std::string_view stop_name) const;
+	BusIdRange GetStopInfo(StopId stop_id) const;
+	void AddDistance(StopId from, StopId to, int distance);
+	std::optional<int> GetDistance(StopId from, StopId to) const;
+	// Длина по дорогам участка полного маршрута автобуса между позициями from <= to в Bus::GetRoute();
+	// nullopt, если для какого-то отрезка маршрута нет расстояния (доступна после Freeze)
+	std::optional<int> GetRouteDistance(BusId bus_id, size_t from, size_t to) const;
+	// Географическая длина того же участка (доступна после Freeze)
+	double GetRouteGeoDistance(BusId bus_id, size_t from, size_t to) const;
+	// Удаляет расстояние от from до to; возвращает false, если его не было
+	bool RemoveDistance(StopId from, StopId to);
+	// Вызывает callback(from, to, distance) для каждого заданного расстояния
+	template <typename Callback>
+	void ForEachDistance(Callback callback) const {
+		distances_.ForEach(callback);
+	}
+	// Строит производные индексы, затронутые изменениями с прошлой заморозки
+	void Freeze();
+	bool IsFrozen() const;
+	// Идентификаторы, упорядоченные по названию (доступны после Freeze)
+	StopIdRange GetStopIdsSortedByName() const;
+	BusIdRange GetBusIdsSortedByName() const;
+	// count ближайших к точке остановок по возрастанию расстояния (доступны после Freeze)
+	std::vector<NearbyStop> NearestStops(geo::Coordinates coordinates, size_t count) const;
+	// Остановки внутри прямоугольника в порядке названий (доступны после Freeze)
+	std::vector<StopId> StopsInBox(const geo::BoundingBox& box) const;
+	// Остановки не дальше radius метров от точки по возрастанию расстояния (доступны после Freeze)
+	std::vector<NearbyStop> StopsInRadius(geo::Coordinates coordinates, double radius) const;
+	// Не более count остановок и автобусов, начало названия которых отличается от query
+	// не более чем на max_errors правок, по возрастанию числа правок и названию (доступны после Freeze).
+	// Число правок не превосходит длины запроса, поэтому больший max_errors ничего не меняет
+	std::vector<NameMatch> SuggestNames(std::string_view query, size_t count, int max_errors) const;
+	memory_stats::MemoryStats GetMemoryStats() const;
 private:
-	std::deque<Stop> stops_;
-	std::unordered_map<std::string_view, Stop*> stopname_to_stop_;
-	std::deque<Bus> buses_;
-	std::unordered_map<std::string_view, Bus*> busname_to_bus_;
-	std::unordered_map<std::string_view, std::set<std::string_view>> stopname_to_busnames_;
-	std::unordered_map<std::pair<Stop*, Stop*>, int, PairPointersHasher> distances_;
+	// Монотонная арена для названий и последовательностей остановок: строки и массивы
+	// не перемещаются, а освобождаются разом вместе с каталогом
+	std::pmr::monotonic_buffer_resource arena_;
+	// Число и суммарный размер размещённых в арене названий и последовательностей
+	memory_stats::Usage arena_usage_;
+	// Названия и координаты остановок хранятся раздельно: пакетные геометрические проходы
+	// читают только плотные массивы широт и долгот
+	std::vector<std::string_view> stop_names_;
+	std::vector<double> stop_lats_;
+	std::vector<double> stop_lngs_;
+	// Широты остановок в радианах с синусом и косинусом: вычисляются при добавлении и перемещении остановки
+	std::vector<geo::PreparedLatitude> stop_latitudes_;
+	std::vector<bool> removed_stops_;
+	// Названия, добавленные после последней заморозки; остальные ищутся через stop_name_hash_
+	std::unordered_map<std::string_view, StopId> stopname_to_id_;
+	PerfectHash stop_name_hash_;
+	std::vector<Bus> buses_;
+	std::vector<bool> removed_buses_;
+	std::unordered_map<std::string_view, BusId> busname_to_id_;
+	PerfectHash bus_name_hash_;
+	std::vector<std::optional<BusInfo>> bus_infos_;
+	std::vector<RouteLengths> route_lengths_;
+	// Статистика автобусов, начиная с этого идентификатора, могла устареть
+	BusId stale_buses_begin_ = 0;
+	// Число остановок и автобусов при последней заморозке
+	size_t frozen_stop_count_ = 0;
+	size_t frozen_bus_count_ = 0;
+	// Автобусы, маршрут которых изменился после построения списков автобусов остановок
+	std::vector<BusId> rerouted_buses_;
+	// Изменения с последней заморозки: какие индексы перестроить
+	UpdateReport pending_changes_;
+	DistanceTable distances_;
+	std::vector<StopId> sorted_stop_ids_;
+	std::vector<BusId> sorted_bus_ids_;
+	// Списки автобусов остановок: stop_bus_ids_[stop_bus_offsets_[id] .. stop_bus_offsets_[id + 1])
+	std::vector<size_t> stop_bus_offsets_;
+	std::vector<BusId> stop_bus_ids_;
+	SpatialIndex stop_index_;
+	bool is_frozen_ = false;
+
+	void CheckFrozen() const;
+	geo::PreparedCoordinatesView GetPreparedStopCoordinates() const;
+	UpdateReport FreezeChanges();
+	RouteLengths ComputeRouteLengths(const Bus& bus) const;
+	std::optional<BusInfo> ComputeBusInfo(const Bus& bus, const RouteLengths& lengths) const;
+	void UpdateBusInfo(BusId bus_id);
+	void InvalidateBusInfos(StopId stop_id);
+	bool IsStopUsed(StopId stop_id) const;
+	StopId ResolveStop(std::string_view stop_name) const;
+	BusId ResolveBus(std::string_view bus_name) const;
+	void BuildStopBusLists();
+	void BuildStopIndex();
+	void BuildNameHashes(const UpdateReport& report);
+	// Добавляют остановку или автобус с названием, уже размещённым в арене или принятым извне
+	StopId InsertStop(std::string_view name, geo::Coordinates coordinates);
+	BusId InsertBus(const Bus& bus);
+	std::string_view StoreName(std::string_view name);
+	ranges::Range<const StopId*> StoreStops(ranges::Range<const StopId*> stops);
 };
 
 }
\ No newline at end of file
@@ -1,29 +1,145 @@
 #include "transport_router.h"
 
+#include <stdexcept>
+
 namespace transport_catalogue {
 namespace transport_router {
 
+namespace {
+
+// Каждой остановке соответствуют две вершины: ожидание автобуса и посадка в него
+graph::VertexId GetWaitVertex(StopId stop_id) {
+    return static_cast<graph::VertexId>(stop_id) * 2;
+}
+
+graph::VertexId GetBoardVertex(StopId stop_id) {
+    return static_cast<graph::VertexId>(stop_id) * 2 + 1;
+}
+
+} // namespace
+
 TransportRouter::TransportRouter(const TransportCatalogue& catalogue, RouterSettings settings) 
-    : settings_(std::move(settings))
-    , stop_to_id_({})
+    : catalogue_(catalogue)
+    , settings_(std::move(settings))
     , edges_({})
+    , edge_distances_({})
     , graph_(BuildGraph(catalogue))
     , router_(graph_) {
 }
 
+TransportRouter::TransportRouter(const TransportCatalogue& catalogue, State state)
+    : catalogue_(catalogue)
+    , settings_(state.settings)
+    , edges_(std::move(state.edge_infos))
+    , edge_distances_(std::move(state.edge_distances))
+    , graph_(RestoreGraph(catalogue, state))
+    , router_(graph_, state.overlay) {
+}
+
 std::optional<RouteInfo> TransportRouter::GetRouteInfo(std::string_view from, std::string_view to) const {
+    auto from_id = catalogue_.FindStopId(from);
+    auto to_id = catalogue_.FindStopId(to);
+    if (!from_id || !to_id) {
+        return std::nullopt;
+    }
+    return GetRouteInfo(*from_id, *to_id);
+}
+
+std::optional<RouteInfo> TransportRouter::GetRouteInfo(StopId from, StopId to) const {
     RouteInfo result;
-    auto route = router_.BuildRoute(stop_to_id_.at(from).first, stop_to_id_.at(to).first);
+    auto route = router_.BuildRoute(GetWaitVertex(from), GetWaitVertex(to));
     if (!route) {
         return std::nullopt;
     }
     result.total_time = route->weight;
     for (auto id : route->edges) {
-        result.items.push_back(edges_.at(id));
+        result.items.push_back(edges_[id]);
     }
     return result;
 }
 
+std::optional<RouteInfo> TransportRouter::GetRouteInfo(geo::Coordinates from, geo::Coordinates to) const {
+    const auto from_stops = catalogue_.StopsInRadius(from, settings_.max_walk_distance);
+    const auto to_stops = catalogue_.StopsInRadius(to, settings_.max_walk_distance);
+
+    std::optional<RouteInfo> result;
+    const double direct_distance = geo::ComputeDistance(from, to);
+    if (direct_distance <= settings_.max_walk_distance) {
+        const double time = ComputeWalkTime(direct_distance);
+        result = RouteInfo{time, {{EdgeType::WALK, {}, std::nullopt, time}}};
+    }
+    if (from_stops.empty() || to_stops.empty()) {
+        return result;
+    }
+
+    std::vector<graph::CrpRouter<double>::Endpoint> sources, targets;
+    sources.reserve(from_stops.size());
+    for (const auto& stop : from_stops) {
+        sources.push_back({GetWaitVertex(stop.id), ComputeWalkTime(stop.distance)});
+    }
+    targets.reserve(to_stops.size());
+    for (const auto& stop : to_stops) {
+        targets.push_back({GetWaitVertex(stop.id), ComputeWalkTime(stop.distance)});
+    }
+    auto route = router_.BuildRoute(sources, targets);
+    if (!route || (result && !(route->weight < result->total_time))) {
+        return result;
+    }
+
+    result = RouteInfo{route->weight, {}};
+    result->items.reserve(route->edges.size() + 2);
+    const StopId from_stop = from_stops[route->source].id;
+    const StopId to_stop = to_stops[route->target].id;
+    result->items.push_back({EdgeType::WALK, catalogue_.GetStop(from_stop).name, std::nullopt,
+                             sources[route->source].weight});
+    for (auto id : route->edges) {
+        result->items.push_back(edges_[id]);
+    }
+    result->items.push_back({EdgeType::WALK, catalogue_.GetStop(to_stop).name, std::nullopt,
+                             targets[route->target].weight});
+    return result;
+}
+
+void TransportRouter::SetSettings(RouterSettings settings) {
+    settings_ = std::move(settings);
+    // Рёбра перебираются по возрастанию id, поэтому время предыдущего участка уже пересчитано
+    // и время складывается из отрезков в том же порядке, что и при построении графа
+    for (graph::EdgeId id = 0; id < graph_.GetEdgeCount(); ++id) {
+        EdgeInfo& edge = edges_[id];
+        if (edge.type == EdgeType::WAIT) {
+            edge.time = settings_.bus_wait_time;
+        } else if (*edge.span_count == 1) {
+            edge.time = ComputeBusTime(edge_distances_[id]);
+        } else {
+            edge.time = edges_.at(id - 1).time + ComputeBusTime(edge_distances_[id] - edge_distances_[id - 1]);
+        }
+        graph_.SetEdgeWeight(id, edge.time);
+    }
+    router_.Customize();
+}
+
+RouterSettings TransportRouter::GetSettings() const {
+    return settings_;
+}
+
+TransportRouter::State TransportRouter::GetState() const {
+    State state{settings_, {}, edges_, edge_distances_, router_.GetOverlay()};
+    state.edges.reserve(graph_.GetEdgeCount());
+    for (graph::EdgeId id = 0; id < graph_.GetEdgeCount(); ++id) {
+        state.edges.push_back(graph_.GetEdge(id));
+    }
+    return state;
+}
+
+memory_stats::MemoryStats TransportRouter::GetMemoryStats() const {
+    memory_stats::MemoryStats stats;
+    stats.Add("edge_infos", memory_stats::GetVectorUsage(edges_));
+    stats.Add("edge_distances", memory_stats::GetVectorUsage(edge_distances_));
+    stats.Add("graph", graph_.GetMemoryStats());
+    stats.Add("crp", router_.GetMemoryStats());
+    return stats;
+}
+
 double TransportRouter::ComputeBusTime(double distance) const {
     const int m_in_km = 1000;
     const int min_in_hour = 60;
@@ -32,57 +148,73 @@ double TransportRouter::ComputeBusTime(double distance) const {
     return time_in_hour * min_in_hour;
 }
 
+double TransportRouter::ComputeWalkTime(double distance) const {
+    const int m_in_km = 1000;
+    const int min_in_hour = 60;
+    return distance / m_in_km / settings_.walk_velocity * min_in_hour;
+}
+
 graph::DirectedWeightedGraph<double> TransportRouter::BuildGraph(const TransportCatalogue& catalogue) {
-    const auto stops = catalogue.GetStopList();
-    graph::DirectedWeightedGraph<double> graph(stops.size() * 2);
-    AddVerticesToGraph(stops);
-    AddWaitEdgesToGraph(graph, stops);
+    graph::DirectedWeightedGraph<double> graph(catalogue.GetStopCount() * 2);
+    AddWaitEdgesToGraph(graph, catalogue);
     AddBusesEdgesToGraph(graph, catalogue);
     return graph;
 }
 
-void TransportRouter::AddVerticesToGraph(const std::unordered_map<std::string_view, Stop*>& stops) {
-    size_t id = 0;
-    for (const auto& [stopname, _] : stops) {
-        stop_to_id_[stopname] = {id , id + 1};
-        id += 2;
+graph::DirectedWeightedGraph<double> TransportRouter::RestoreGraph(const TransportCatalogue& catalogue, State& state) {
+    const size_t edge_count = state.edges.size();
+    if (edges_.size() != edge_count || edge_distances_.size() != edge_count) {
+        throw std::invalid_argument("Router edge arrays have different sizes");
     }
+    for (const EdgeInfo& edge : edges_) {
+        if (edge.type == EdgeType::WALK || (edge.type == EdgeType::BUS && (!edge.span_count || *edge.span_count < 1))) {
+            throw std::invalid_argument("Invalid router edge");
+        }
+    }
+    graph::DirectedWeightedGraph<double> graph(catalogue.GetStopCount() * 2, std::move(state.edges));
+    return graph;
 }
 
-void TransportRouter::AddWaitEdgesToGraph(graph::DirectedWeightedGraph<double>& graph,
-                                          const std::unordered_map<std::string_view, Stop*>& stops) {
-    for (const auto& [stopname, _] : stops) {
-        const auto [from, to] = stop_to_id_[stopname];
-        size_t id = graph.AddEdge({from, to, settings_.bus_wait_time});
-        edges_[id] = {EdgeType::WAIT, stopname, std::nullopt, settings_.bus_wait_time};
+void TransportRouter::AddWaitEdgesToGraph(graph::DirectedWeightedGraph<double>& graph, const TransportCatalogue& catalogue) {
+    for (StopId stop_id = 0; stop_id < catalogue.GetStopCount(); ++stop_id) {
+        graph.AddEdge({GetWaitVertex(stop_id), GetBoardVertex(stop_id), settings_.bus_wait_time});
+        edges_.push_back({EdgeType::WAIT, catalogue.GetStop(stop_id).name, std::nullopt, settings_.bus_wait_time});
+        edge_distances_.push_back(0);
     }
 }
 
 void TransportRouter::AddBusesEdgesToGraph(graph::DirectedWeightedGraph<double>& graph, const TransportCatalogue& catalogue) {
-    for (const auto& [busname, bus] : catalogue.GetBusList()) {
-        if (bus->is_round) {
-            AddBusEdgesToGraph(graph, catalogue, busname, bus->stops, 0, bus->stops.size() - 1);
-        } else {
-            size_t one_direction = bus->stops.size() / 2;
-            AddBusEdgesToGraph(graph, catalogue, busname, bus->stops, 0, one_direction);
-            AddBusEdgesToGraph(graph, catalogue, busname, bus->stops, one_direction, bus->stops.size() - 1);
+    for (BusId bus_id = 0; bus_id < catalogue.GetBusCount(); ++bus_id) {
+        const Bus& bus = catalogue.GetBus(bus_id);
+        if (bus.stops.empty()) {
+            continue;
+        }
+        // Некольцевой маршрут хранит путь в одну сторону, обратный проходится отдельно
+        const size_t one_direction = bus.stops.size() - 1;
+        AddBusEdgesToGraph(graph, catalogue, bus_id, 0, one_direction);
+        if (!bus.is_round) {
+            AddBusEdgesToGraph(graph, catalogue, bus_id, one_direction, bus.GetRoute().size() - 1);
         }
     }
 }
 
 void TransportRouter::AddBusEdgesToGraph(graph::DirectedWeightedGraph<double>& graph, const TransportCatalogue& catalogue, 
-                                         std::string_view busname, const std::vector<Stop*>& stops, size_t start_stop, size_t end_stop) {
-    for (size_t i = start_stop; i <= end_stop - 1; ++i) {
-        auto stop_from = stops[i]->name;
-        size_t id_from = stop_to_id_.at(stop_from).second;
+                                         BusId bus_id, size_t start_stop, size_t end_stop) {
+    const Bus& bus = catalogue.GetBus(bus_id);
+    const RouteView stops = bus.GetRoute();
+    for (size_t i = start_stop; i < end_stop; ++i) {
         int span_count = 1;
         double weight = 0.0;
+        int distance = 0;
         for (size_t j = i + 1; j <= end_stop; ++j) {
-            auto stop_to = stops[j]->name;
-            size_t id_to = stop_to_id_.at(stop_to).first;
-            weight += ComputeBusTime(*catalogue.GetDistance(stops[j - 1]->name, stop_to));
-            size_t id = graph.AddEdge({id_from, id_to, weight});
-            edges_[id] = {EdgeType::BUS, busname, span_count++, weight};
+            // Время участка складывается из времени отрезков, как в исходной версии: время всего
+            // участка по его длине может отличаться в последнем знаке и изменить выбор маршрута
+            const int segment = *catalogue.GetRouteDistance(bus_id, j - 1, j);
+            weight += ComputeBusTime(segment);
+            distance += segment;
+            graph.AddEdge({GetBoardVertex(stops[i]), GetWaitVertex(stops[j]), weight});
+            edges_.push_back({EdgeType::BUS, bus.name, span_count++, weight});
+            edge_distances_.push_back(distance);
         }
     }
 }
@@ -1,10 +1,9 @@
 #pragma once
 
-#include "router.h"
+#include "crp_router.h"
 #include "transport_catalogue.h"
 
 #include <optional>
-#include <unordered_map>
 #include <utility>
 #include <string>
 #include <string_view>
@@ -16,9 +15,14 @@ namespace transport_router {
 struct RouterSettings {
     double bus_wait_time;
     double bus_velocity;
+    // Скорость пешехода (км/ч) и наибольшее расстояние пешком до остановки (м) для маршрутов между точками
+    double walk_velocity = 5.0;
+    double max_walk_distance = 1000.0;
 };
 
-enum class EdgeType {WAIT, BUS};
+// Пеший участок WALK ведёт от начальной точки к остановке name, от остановки name к конечной точке
+// или, при пустом name, напрямую между точками
+enum class EdgeType {WAIT, BUS, WALK};
 
 struct EdgeInfo {
     EdgeType type;
@@ -34,23 +38,51 @@ struct RouteInfo {
 
 class TransportRouter {
 public:
+    // Построенный маршрутизатор в плоском виде: сохраняется в снимок и восстанавливается без построения
+    // графа и предобработки. Ребро i графа описывают edges[i], edge_infos[i] и edge_distances[i];
+    // названия в edge_infos должны жить дольше маршрутизатора
+    struct State {
+        RouterSettings settings;
+        std::vector<graph::Edge<double>> edges;
+        std::vector<EdgeInfo> edge_infos;
+        std::vector<int> edge_distances;
+        graph::CrpRouter<double>::Overlay overlay;
+    };
+
     explicit TransportRouter(const TransportCatalogue& catalogue, RouterSettings settings);
+    // Восстанавливает маршрутизатор, сохранённый GetState для того же каталога.
+    // Выбрасывает std::invalid_argument, если массивы не согласованы с каталогом или между собой
+    TransportRouter(const TransportCatalogue& catalogue, State state);
     std::optional<RouteInfo> GetRouteInfo(std::string_view from, std::string_view to) const;
+    std::optional<RouteInfo> GetRouteInfo(StopId from, StopId to) const;
+    // Маршрут между точками: остановки в радиусе max_walk_distance от начала и конца становятся
+    // начальными и конечными вершинами одного поиска с весами, равными времени пути пешком
+    std::optional<RouteInfo> GetRouteInfo(geo::Coordinates from, geo::Coordinates to) const;
+    // Пересчитывает веса рёбер и перезапускает настройку CrpRouter без перестроения графа и его разбиения
+    void SetSettings(RouterSettings settings);
+    RouterSettings GetSettings() const;
+    State GetState() const;
+    memory_stats::MemoryStats GetMemoryStats() const;
 
 private:
+    const TransportCatalogue& catalogue_;
     RouterSettings settings_;
-    std::unordered_map<std::string_view, std::pair<size_t, size_t>> stop_to_id_;
-    std::unordered_map<size_t, EdgeInfo> edges_;
+    // Описания рёбер по их идентификаторам
+    std::vector<EdgeInfo> edges_;
+    // Длина участка по дорогам для каждого ребра (0 для ожидания); участки одного автобуса от одной
+    // остановки идут подряд с span_count 1, 2, ..., и длина отрезка — разность соседних длин
+    std::vector<int> edge_distances_;
     graph::DirectedWeightedGraph<double> graph_;
-    graph::Router<double> router_;
+    graph::CrpRouter<double> router_;
 
     double ComputeBusTime(double distance) const;
+    double ComputeWalkTime(double distance) const;
     graph::DirectedWeightedGraph<double> BuildGraph(const TransportCatalogue& catalogue);
-    void AddVerticesToGraph(const std::unordered_map<std::string_view, Stop*>& stops);
-    void AddWaitEdgesToGraph(graph::DirectedWeightedGraph<double>& graph, const std::unordered_map<std::string_view, Stop*>& stops);
+    graph::DirectedWeightedGraph<double> RestoreGraph(const TransportCatalogue& catalogue, State& state);
+    void AddWaitEdgesToGraph(graph::DirectedWeightedGraph<double>& graph, const TransportCatalogue& catalogue);
     void AddBusesEdgesToGraph(graph::DirectedWeightedGraph<double>& graph, const TransportCatalogue& catalogue);
-    void AddBusEdgesToGraph(graph::DirectedWeightedGraph<double>& graph, const TransportCatalogue& catalogue, std::string_view busname,
-                            const std::vector<Stop*>& stops, size_t start_stop, size_t end_stop);
+    void AddBusEdgesToGraph(graph::DirectedWeightedGraph<double>& graph, const TransportCatalogue& catalogue, BusId bus_id,
+                            size_t start_stop, size_t end_stop);
 };
 
 } // transport_router